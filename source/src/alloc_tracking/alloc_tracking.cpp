@@ -0,0 +1,206 @@
+#include "alloc_tracking.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace alloc_tracking
+{
+namespace
+{
+thread_local scope* innermost = nullptr;
+
+std::atomic<std::size_t> total_allocations{0};
+std::atomic<std::size_t> total_deallocations{0};
+std::atomic<std::size_t> total_bytes{0};
+std::atomic<std::size_t> total_live{0};
+std::atomic<std::size_t> total_peak{0};
+
+// Keeps the blocks handed out as aligned as malloc's
+std::size_t const header = alignof(std::max_align_t);
+
+// Over-aligned blocks get a header as large as their alignment, so that the
+// block after it stays aligned
+std::size_t header_for(std::size_t alignment)
+{
+    return std::max(alignment, header);
+}
+
+void* allocate(std::size_t size, std::size_t alignment = header)
+{
+    std::size_t const h = header_for(alignment);
+    // aligned_alloc needs a multiple of the alignment
+    std::size_t const rounded = (size + h + alignment - 1) / alignment * alignment;
+    void* const raw = alignment <= header ? std::malloc(size + h)
+                                          : std::aligned_alloc(alignment, rounded);
+    auto* const block = static_cast<unsigned char*>(raw);
+    if (block == nullptr)
+        return nullptr;
+    *reinterpret_cast<std::size_t*>(block) = size;
+
+    total_allocations.fetch_add(1, std::memory_order_relaxed);
+    total_bytes.fetch_add(size, std::memory_order_relaxed);
+    std::size_t const live = total_live.fetch_add(size, std::memory_order_relaxed) + size;
+    std::size_t peak = total_peak.load(std::memory_order_relaxed);
+    while (live > peak &&
+           !total_peak.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+    {
+    }
+
+    if (innermost != nullptr)
+        innermost->on_allocate(size);
+    return block + h;
+}
+
+void deallocate(void* p, std::size_t alignment = header)
+{
+    if (p == nullptr)
+        return;
+    auto* const block = static_cast<unsigned char*>(p) - header_for(alignment);
+    std::size_t const size = *reinterpret_cast<std::size_t*>(block);
+
+    total_deallocations.fetch_add(1, std::memory_order_relaxed);
+    total_live.fetch_sub(size, std::memory_order_relaxed);
+    if (innermost != nullptr)
+        innermost->on_deallocate(size);
+    std::free(block);
+}
+} // namespace
+
+scope::scope() : parent_{innermost}
+{
+    innermost = this;
+}
+
+scope::~scope()
+{
+    innermost = parent_;
+}
+
+void scope::on_allocate(std::size_t size)
+{
+    ++stats_.allocations;
+    stats_.bytes += size;
+    live_ += static_cast<std::ptrdiff_t>(size);
+    if (live_ > 0)
+        stats_.peak = std::max(stats_.peak, static_cast<std::size_t>(live_));
+    if (parent_ != nullptr)
+        parent_->on_allocate(size);
+}
+
+void scope::on_deallocate(std::size_t size)
+{
+    ++stats_.deallocations;
+    live_ -= static_cast<std::ptrdiff_t>(size);
+    if (parent_ != nullptr)
+        parent_->on_deallocate(size);
+}
+
+alloc_stats totals()
+{
+    alloc_stats result;
+    result.allocations = total_allocations.load(std::memory_order_relaxed);
+    result.deallocations = total_deallocations.load(std::memory_order_relaxed);
+    result.bytes = total_bytes.load(std::memory_order_relaxed);
+    result.peak = total_peak.load(std::memory_order_relaxed);
+    return result;
+}
+} // namespace alloc_tracking
+
+///////////////////////////////////////////////////////////////////////////
+//  The replaced operators. The array, nothrow and over-aligned forms are
+//  replaced too, so that no block reaches a delete that does not expect the
+//  header.
+///////////////////////////////////////////////////////////////////////////
+void* operator new(std::size_t size)
+{
+    if (void* p = alloc_tracking::allocate(size))
+        return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return ::operator new(size);
+}
+
+void* operator new(std::size_t size, std::nothrow_t const&) noexcept
+{
+    return alloc_tracking::allocate(size);
+}
+
+void* operator new[](std::size_t size, std::nothrow_t const&) noexcept
+{
+    return alloc_tracking::allocate(size);
+}
+
+void operator delete(void* p) noexcept { alloc_tracking::deallocate(p); }
+void operator delete[](void* p) noexcept { alloc_tracking::deallocate(p); }
+void operator delete(void* p, std::size_t) noexcept { alloc_tracking::deallocate(p); }
+void operator delete[](void* p, std::size_t) noexcept { alloc_tracking::deallocate(p); }
+void operator delete(void* p, std::nothrow_t const&) noexcept
+{
+    alloc_tracking::deallocate(p);
+}
+
+void operator delete[](void* p, std::nothrow_t const&) noexcept
+{
+    alloc_tracking::deallocate(p);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    if (void* p = alloc_tracking::allocate(size, static_cast<std::size_t>(alignment)))
+        return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return ::operator new(size, alignment);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment,
+                   std::nothrow_t const&) noexcept
+{
+    return alloc_tracking::allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment,
+                     std::nothrow_t const&) noexcept
+{
+    return alloc_tracking::allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* p, std::align_val_t alignment) noexcept
+{
+    alloc_tracking::deallocate(p, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void* p, std::align_val_t alignment) noexcept
+{
+    alloc_tracking::deallocate(p, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t alignment) noexcept
+{
+    alloc_tracking::deallocate(p, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void* p, std::size_t, std::align_val_t alignment) noexcept
+{
+    alloc_tracking::deallocate(p, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* p, std::align_val_t alignment,
+                     std::nothrow_t const&) noexcept
+{
+    alloc_tracking::deallocate(p, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void* p, std::align_val_t alignment,
+                       std::nothrow_t const&) noexcept
+{
+    alloc_tracking::deallocate(p, static_cast<std::size_t>(alignment));
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+
+namespace alloc_tracking
+{
+///////////////////////////////////////////////////////////////////////////
+//  Heap allocation counting
+//
+//  Linking this library replaces the global operator new and delete with
+//  versions that count every allocation. A scope sees what its thread
+//  allocates and frees while it is alive, inner scopes included, so
+//  allocation budgets of a parse or an evaluation can be asserted in
+//  tests and reported by benchmarks. Each block carries a small header
+//  holding its size, so that frees and the peak can be counted too.
+///////////////////////////////////////////////////////////////////////////
+struct alloc_stats
+{
+    std::size_t allocations = 0;
+    std::size_t deallocations = 0;
+    std::size_t bytes = 0; // allocated in total
+    std::size_t peak = 0;  // most bytes live at once, counted from the start
+};
+
+class scope
+{
+public:
+    scope();
+    ~scope();
+
+    scope(scope const&) = delete;
+    scope& operator=(scope const&) = delete;
+
+    alloc_stats const& stats() const { return stats_; }
+
+    // Called by the replaced operators for every scope of the thread
+    void on_allocate(std::size_t size);
+    void on_deallocate(std::size_t size);
+
+private:
+    scope* parent_;
+    alloc_stats stats_;
+    // Blocks freed here may have been allocated before the scope started
+    std::ptrdiff_t live_ = 0;
+};
+
+// What all threads allocated since the program started
+alloc_stats totals();
+
+// The allocations made by calling f
+template <typename F>
+alloc_stats measure(F&& f)
+{
+    scope s;
+    std::forward<F>(f)();
+    return s.stats();
+}
+} // namespace alloc_tracking
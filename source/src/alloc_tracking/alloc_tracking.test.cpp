@@ -0,0 +1,167 @@
+#include "alloc_tracking.hpp"
+
+#include "ast.hpp"
+#include "employee.hpp"
+#include "employee_bulk.hpp"
+#include "function_expression.hpp"
+#include "rexpr/bulk.hpp"
+#include "roman.hpp"
+
+#include <catch.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+// Optimized builds may elide a new/delete pair whose pointer goes nowhere
+char* volatile escape = nullptr;
+} // namespace
+
+TEST_CASE("scopes count allocations, frees and the peak", "[alloc_tracking]")
+{
+    auto const stats = alloc_tracking::measure([] {
+        auto big = std::make_unique<char[]>(100);
+        escape = big.get();
+        big.reset();
+        auto small = std::make_unique<char[]>(50);
+        escape = small.get();
+    });
+    CHECK(stats.allocations == 2);
+    CHECK(stats.deallocations == 2);
+    CHECK(stats.bytes == 150);
+    CHECK(stats.peak == 100);
+
+    CHECK(alloc_tracking::measure([] {}).allocations == 0);
+}
+
+TEST_CASE("over-aligned allocations are counted and stay aligned", "[alloc_tracking]")
+{
+    struct alignas(64) line
+    {
+        char bytes[64];
+    };
+
+    bool aligned = true;
+    auto const stats = alloc_tracking::measure([&] {
+        auto one = std::make_unique<line>();
+        auto many = std::make_unique<line[]>(3);
+        aligned = reinterpret_cast<std::uintptr_t>(one.get()) % alignof(line) == 0 &&
+                  reinterpret_cast<std::uintptr_t>(many.get()) % alignof(line) == 0;
+        escape = one->bytes;
+    });
+    CHECK(aligned);
+    CHECK(stats.allocations == 2);
+    CHECK(stats.deallocations == 2);
+    CHECK(stats.bytes >= 4 * sizeof(line));
+}
+
+TEST_CASE("scopes nest and only see their own thread", "[alloc_tracking]")
+{
+    auto before = std::make_unique<int>(0);
+    auto const totals_before = alloc_tracking::totals();
+
+    // Checked once the scopes end, as the assertions allocate too
+    alloc_tracking::alloc_stats outer_stats;
+    alloc_tracking::alloc_stats inner_stats;
+    {
+        alloc_tracking::scope outer;
+        std::vector<int> v(10);
+        {
+            alloc_tracking::scope inner;
+            std::vector<int> w(20);
+            before.reset();
+            inner_stats = inner.stats();
+        }
+        std::thread([] { std::vector<int> elsewhere(1000); }).join();
+        outer_stats = outer.stats();
+    }
+
+    CHECK(inner_stats.allocations == 1);
+    CHECK(inner_stats.deallocations == 1);
+    CHECK(inner_stats.peak == 20 * sizeof(int));
+    // Both vectors and the thread's state, but not what the thread allocated
+    CHECK(outer_stats.allocations == 3);
+    CHECK(outer_stats.bytes < 1000 * sizeof(int));
+    CHECK(alloc_tracking::totals().allocations >= totals_before.allocations + 4);
+}
+
+TEST_CASE("expression evaluation does not allocate", "[alloc_tracking]")
+{
+    using namespace drakmoor;
+    auto expr = expression{1.0} + expression{"x"} * expression{"x"} / expression{2.0};
+    arg_map const am = {{"x", 3.0}};
+
+    auto const stats = alloc_tracking::measure([&] { expr.eval_at(am); });
+    CHECK(stats.allocations == 0);
+}
+
+TEST_CASE("compound construction stays within its budget", "[alloc_tracking]")
+{
+    using namespace drakmoor;
+    expression const x{"x"};
+
+    // The constant, the compound and its operand vector; x is shared
+    auto const stats = alloc_tracking::measure([&] { auto sum = expression{1.0} + x; });
+    CHECK(stats.allocations <= 3);
+    CHECK(stats.deallocations == stats.allocations);
+}
+
+TEST_CASE("employee parsing stays within its budget", "[alloc_tracking]")
+{
+    std::string const record = R"(employee{34, "Ada", "Lovelace", 1234.5})";
+    char const* const first = record.data();
+    char const* const last = first + record.size();
+
+    // Short names fit in the strings themselves
+    client::ast::employee emp;
+    auto const rule = alloc_tracking::measure([&] {
+        char const* iter = first;
+        phrase_parse(iter, last, client::employee(), boost::spirit::x3::ascii::space,
+                     emp);
+    });
+    CHECK(rule.allocations == 0);
+    CHECK(emp.surname == "Lovelace");
+
+    client::employee_table table;
+    table.reserve(1, 64);
+    auto const bulk = alloc_tracking::measure(
+        [&] { client::parse_employees(first, last, table); });
+    CHECK(bulk.allocations == 0);
+    CHECK(table.size() == 1);
+}
+
+TEST_CASE("rexpr parsing stays within its budget", "[alloc_tracking]")
+{
+    std::string const text = R"({ "name" = "service" "limits" = { "cpu" = 0.5 } })";
+    std::ostringstream err;
+
+    std::size_t count = 0;
+    auto const stats = alloc_tracking::measure([&] {
+        rexpr::parse_all(text.data(), text.data() + text.size(),
+                         [&](rexpr::ast::rexpr&&) { ++count; }, err);
+    });
+    REQUIRE(count == 1);
+    // Map nodes, the nested rexpr and the error handler's position cache
+    CHECK(stats.allocations <= 7);
+    CHECK(stats.deallocations == stats.allocations);
+}
+
+TEST_CASE("roman numeral conversion does not allocate", "[alloc_tracking]")
+{
+    std::string_view const numerals[] = {"MCMXCIV", "XLII", "junk"};
+    unsigned values[std::size(numerals)];
+    char out[roman::max_length];
+
+    auto const stats = alloc_tracking::measure([&] {
+        roman::roman_to_uint(std::begin(numerals), std::end(numerals), values);
+        roman::roman_to_uint(numerals[0]);
+        roman::uint_to_roman(3888, out);
+    });
+    CHECK(stats.allocations == 0);
+    CHECK(values[0] == 1994);
+}
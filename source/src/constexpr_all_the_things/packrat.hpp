@@ -0,0 +1,187 @@
+#ifndef DRAKMOOR_PACKRAT
+#define DRAKMOOR_PACKRAT
+
+#include "parsers.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+namespace parsers
+{
+
+// Results of memoized rules for one parse of one input, keyed by (rule id,
+// offset into the input) and by where the view handed to the rule ends, since
+// a rule run on a shorter view of the same input may parse less. Results live
+// in an arena released with the table; the hash index is open addressing over
+// 24-byte slots. Once storing another
+// result would take the table past `max_bytes`, rules keep working but are no
+// longer cached, so memory stays bounded at the price of re-parsing.
+//
+// A rule id must always be used with the same result type.
+class memo_table
+{
+public:
+    explicit memo_table(parse_input_t input_init,
+                        std::size_t max_bytes_init = std::size_t{64} << 20)
+        : input(input_init), max_bytes(max_bytes_init)
+    {
+    }
+
+    memo_table(const memo_table&) = delete;
+    memo_table& operator=(const memo_table&) = delete;
+
+    ~memo_table()
+    {
+        for (auto* e = needs_destruction; e != nullptr; e = e->next)
+        {
+            e->destroy(e);
+        }
+    }
+
+    template <typename T>
+    const parse_result<T>* find(std::uint32_t rule, parse_input_t at)
+    {
+        std::uint64_t k = 0;
+        std::uint64_t end = 0;
+        if (!key_of(rule, at, k, end) || slots.empty()) return nullptr;
+
+        for (std::size_t i = home_slot(k);; i = (i + 1) & (slots.size() - 1))
+        {
+            if (slots[i].target == nullptr) break;
+            if (slots[i].key == k && slots[i].end == end)
+            {
+                ++hit_count;
+                return &static_cast<entry<T>*>(slots[i].target)->result;
+            }
+        }
+        return nullptr;
+    }
+
+    template <typename T>
+    void store(std::uint32_t rule, parse_input_t at, const parse_result<T>& result)
+    {
+        std::uint64_t k = 0;
+        std::uint64_t end = 0;
+        if (!key_of(rule, at, k, end)) return;
+
+        if (2 * (stored + 1) > slots.size() && !grow_index()) return;
+        if (used + sizeof(entry<T>) > max_bytes) return;
+
+        auto* e = new (arena.allocate(sizeof(entry<T>), alignof(entry<T>))) entry<T>(result);
+        used += sizeof(entry<T>);
+        if constexpr (!std::is_trivially_destructible_v<parse_result<T>>)
+        {
+            e->destroy = [](entry_base* self) { static_cast<entry<T>*>(self)->~entry<T>(); };
+            e->next = needs_destruction;
+            needs_destruction = e;
+        }
+
+        auto i = home_slot(k);
+        while (slots[i].target != nullptr)
+        {
+            i = (i + 1) & (slots.size() - 1);
+        }
+        slots[i] = slot{k, end, e};
+        ++stored;
+    }
+
+    std::size_t entries() const { return stored; }
+    std::size_t hits() const { return hit_count; }
+    std::size_t bytes_used() const { return used; }
+
+private:
+    struct entry_base
+    {
+        entry_base* next = nullptr;
+        void (*destroy)(entry_base*) = nullptr;
+    };
+
+    template <typename T>
+    struct entry : entry_base
+    {
+        explicit entry(const parse_result<T>& r) : result(r) {}
+        parse_result<T> result;
+    };
+
+    struct slot
+    {
+        std::uint64_t key = 0;
+        std::uint64_t end = 0;
+        entry_base* target = nullptr;
+    };
+
+    // Offsets past 32 bits (inputs over 4 GB) and views reaching outside the
+    // input are simply not memoized.
+    bool key_of(std::uint32_t rule, parse_input_t at, std::uint64_t& k,
+                std::uint64_t& end) const
+    {
+        if (at.data() < input.data() || at.data() > input.data() + input.size()) return false;
+        const auto offset = static_cast<std::uint64_t>(at.data() - input.data());
+        if (offset > 0xFFFFFFFFu || at.size() > input.size() - offset) return false;
+        k = (std::uint64_t{rule} << 32) | offset;
+        end = offset + at.size();
+        return true;
+    }
+
+    std::size_t home_slot(std::uint64_t k) const
+    {
+        // Fibonacci hashing spreads consecutive offsets over the table
+        return static_cast<std::size_t>((k * 0x9E3779B97F4A7C15ull) >> 32) & (slots.size() - 1);
+    }
+
+    bool grow_index()
+    {
+        const std::size_t capacity = slots.empty() ? 64 : 2 * slots.size();
+        const std::size_t index_bytes = capacity * sizeof(slot);
+        if (used - slots.size() * sizeof(slot) + index_bytes > max_bytes) return false;
+
+        std::vector<slot> old(capacity);
+        old.swap(slots);
+        used += index_bytes - old.size() * sizeof(slot);
+        for (const auto& s : old)
+        {
+            if (s.target == nullptr) continue;
+            auto i = home_slot(s.key);
+            while (slots[i].target != nullptr)
+            {
+                i = (i + 1) & (slots.size() - 1);
+            }
+            slots[i] = s;
+        }
+        return true;
+    }
+
+    parse_input_t input;
+    std::size_t max_bytes;
+    std::size_t used = 0;
+    std::size_t stored = 0;
+    std::size_t hit_count = 0;
+    std::vector<slot> slots;
+    std::pmr::monotonic_buffer_resource arena;
+    entry_base* needs_destruction = nullptr;
+};
+
+// p, with its results cached in `table` under `rule`. Re-running the rule at an
+// offset it has already been tried at returns the cached result, which makes
+// backtracking through nested alternatives linear in the input.
+template <typename P>
+auto memoize(std::uint32_t rule, P&& p, memo_table& table)
+{
+    using T = parse_t<P>;
+    return [rule, p = std::forward<P>(p), t = &table] (parse_input_t i) -> parse_result<T>
+    {
+        if (const auto* cached = t->find<T>(rule, i))
+        {
+            return *cached;
+        }
+        auto r = p(i);
+        t->store(rule, i, r);
+        return r;
+    };
+}
+
+}
+
+#endif // DRAKMOOR_PACKRAT
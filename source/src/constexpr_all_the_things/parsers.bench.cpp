@@ -0,0 +1,226 @@
+// Throughput of the combinators on large inputs. Every parse runs on a
+// whitespace-and-ints stream and reports MB/s together with the number of heap
+// allocations made while parsing, which should stay flat as the input grows.
+#include "parsers.hpp"
+
+#include "alloc_tracking.hpp"
+
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+using namespace parsers;
+
+std::string make_input(std::size_t bytes)
+{
+    static constexpr char separators[] = {' ', ' ', ' ', '\t', '\n', '\r'};
+    std::mt19937 gen{42};
+    std::uniform_int_distribution<int> value{1, 99999};
+    std::uniform_int_distribution<std::size_t> separator{0, sizeof(separators) - 1};
+    std::uniform_int_distribution<int> run{1, 3};
+
+    std::string input;
+    input.reserve(bytes + 16);
+    while (input.size() < bytes)
+    {
+        for (int i = run(gen); i > 0; --i)
+        {
+            input += separators[separator(gen)];
+        }
+        input += std::to_string(value(gen));
+    }
+    return input;
+}
+
+// whitespace runs of 1..64 bytes between short words
+std::string make_blank_input(std::size_t bytes)
+{
+    static constexpr char blanks[] = {' ', '\t', '\n', '\r'};
+    std::mt19937 gen{43};
+    std::uniform_int_distribution<std::size_t> blank{0, sizeof(blanks) - 1};
+    std::uniform_int_distribution<int> run{1, 64};
+
+    std::string input;
+    input.reserve(bytes + 80);
+    while (input.size() < bytes)
+    {
+        for (int i = run(gen); i > 0; --i)
+        {
+            input += blanks[blank(gen)];
+        }
+        input += "word";
+    }
+    return input;
+}
+
+// the one-byte-at-a-time whitespace skipper skip_whitespace used to be
+auto byte_at_a_time_whitespace()
+{
+    auto char_parser = [](char c) {
+        return [c](parse_input_t s) -> parse_result_t<char> {
+            if (s.empty() || s[0] != c) return std::nullopt;
+            return parse_result_t<char>(std::make_pair(c, s.substr(1)));
+        };
+    };
+    auto ws = char_parser(' ') | char_parser('\t') | char_parser('\n') | char_parser('\r');
+    return many(ws, std::monostate{}, [](auto m, auto) { return m; });
+}
+
+template <typename Parser>
+void run(const char* name, const std::string& input, Parser&& parser)
+{
+    alloc_tracking::scope counted;
+    const auto start = std::chrono::steady_clock::now();
+    const auto r = parser(parse_input_t(input));
+    const auto stop = std::chrono::steady_clock::now();
+    const auto allocations = counted.stats().allocations;
+
+    const std::chrono::duration<double> seconds = stop - start;
+    const double mb = static_cast<double>(input.size()) / (1024.0 * 1024.0);
+    std::printf("%-24s %8.2f MB %10.2f MB/s %8.3f ns/byte %10zu allocs  left=%zu\n", name,
+                mb, mb / seconds.count(),
+                seconds.count() * 1e9 / static_cast<double>(input.size()), allocations,
+                r ? r->second.size() : input.size());
+}
+// Space separated numbers; parse_one(first, last, sum) parses one number at
+// first, adds it to sum and returns the position after it (nullptr on error).
+template <typename T, typename ParseOne>
+void run_numbers(const char* name, const std::string& input, ParseOne parse_one)
+{
+    const auto start = std::chrono::steady_clock::now();
+    const char* p = input.data();
+    const char* const last = input.data() + input.size();
+    T sum{};
+    std::size_t count = 0;
+    while (p != nullptr && p < last)
+    {
+        p = parse_one(p, last, sum);
+        ++count;
+        if (p != nullptr && p < last) ++p; // the separator
+    }
+    const auto stop = std::chrono::steady_clock::now();
+
+    const std::chrono::duration<double> seconds = stop - start;
+    const double mb = static_cast<double>(input.size()) / (1024.0 * 1024.0);
+    std::printf("%-24s %8.2f MB %10.2f MB/s %10.2f Mnum/s  %s\n", name, mb,
+                mb / seconds.count(), static_cast<double>(count) / seconds.count() / 1e6,
+                p == nullptr ? "FAILED" : "");
+}
+
+template <typename T, typename Distribution>
+std::string make_numbers(std::size_t bytes, Distribution distribution)
+{
+    std::mt19937_64 gen{44};
+    std::string input;
+    input.reserve(bytes + 32);
+    char text[32];
+    while (input.size() < bytes)
+    {
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            std::snprintf(text, sizeof(text), "%.17g", distribution(gen));
+        }
+        else
+        {
+            std::snprintf(text, sizeof(text), "%lld", static_cast<long long>(distribution(gen)));
+        }
+        input += text;
+        input += ' ';
+    }
+    return input;
+}
+
+void bench_numbers(std::size_t megabytes)
+{
+    const auto ints = make_numbers<long long>(
+        megabytes * 1024 * 1024, std::uniform_int_distribution<long long>{-1000000000000000ll,
+                                                                          1000000000000000ll});
+    run_numbers<long long>("int_parser<long long>", ints,
+                           [p = int_parser<long long>()](const char* first, const char* last,
+                                                         long long& sum) -> const char* {
+                               const auto r = p(parse_input_t(first, static_cast<std::size_t>(last - first)));
+                               if (!r) return nullptr;
+                               sum += r->first;
+                               return r->second.data();
+                           });
+    run_numbers<long long>("std::from_chars (int)", ints,
+                           [](const char* first, const char* last, long long& sum) -> const char* {
+                               long long v = 0;
+                               const auto r = std::from_chars(first, last, v);
+                               if (r.ec != std::errc{}) return nullptr;
+                               sum += v;
+                               return r.ptr;
+                           });
+    run_numbers<long long>("std::strtoll", ints,
+                           [](const char* first, const char*, long long& sum) -> const char* {
+                               char* end = nullptr;
+                               sum += std::strtoll(first, &end, 10);
+                               return end == first ? nullptr : end;
+                           });
+
+    const auto floats = make_numbers<double>(
+        megabytes * 1024 * 1024, std::uniform_real_distribution<double>{-1e6, 1e6});
+    run_numbers<double>("float_parser<double>", floats,
+                        [p = float_parser<double>()](const char* first, const char* last,
+                                                     double& sum) -> const char* {
+                            const auto r = p(parse_input_t(first, static_cast<std::size_t>(last - first)));
+                            if (!r) return nullptr;
+                            sum += r->first;
+                            return r->second.data();
+                        });
+    run_numbers<double>("std::from_chars (double)", floats,
+                        [](const char* first, const char* last, double& sum) -> const char* {
+                            double v = 0;
+                            const auto r = std::from_chars(first, last, v);
+                            if (r.ec != std::errc{}) return nullptr;
+                            sum += v;
+                            return r.ptr;
+                        });
+    run_numbers<double>("std::strtod", floats,
+                        [](const char* first, const char*, double& sum) -> const char* {
+                            char* end = nullptr;
+                            sum += std::strtod(first, &end);
+                            return end == first ? nullptr : end;
+                        });
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const std::size_t megabytes = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10;
+
+    const auto token = skip_whitespace() < int_parser();
+    const auto sum = many(token, 0LL, [](long long acc, int v) { return acc + v; });
+    const auto collect = many(token, std::vector<int>{}, [](std::vector<int> acc, int v) {
+        acc.push_back(v);
+        return acc;
+    });
+
+    for (std::size_t size = megabytes / 10 == 0 ? 1 : megabytes / 10; size <= megabytes;
+         size *= 10)
+    {
+        const auto input = make_input(size * 1024 * 1024);
+        run("sum ints", input, sum);
+        run("collect ints", input, collect);
+        run("discard ints", input, many(token | fail(0), std::monostate{},
+                                        [](std::monostate m, int) { return m; }));
+
+        const auto blank_input = make_blank_input(size * 1024 * 1024);
+        const auto word = take_while(none_of(" \t\n\r"));
+        run("skip blanks (swar)", blank_input,
+            many(skip_whitespace() < word, std::monostate{},
+                 [](std::monostate m, auto) { return m; }));
+        run("skip blanks (bytewise)", blank_input,
+            many(byte_at_a_time_whitespace() < word, std::monostate{},
+                 [](std::monostate m, auto) { return m; }));
+    }
+
+    bench_numbers(megabytes);
+    return 0;
+}
@@ -0,0 +1,93 @@
+// Compile-time checks: everything in this file is evaluated by the compiler.
+// It is also a second translation unit including parsers.hpp, so the
+// executable only links if the header is ODR-safe.
+#include "parsers.hpp"
+
+namespace
+{
+using namespace parsers;
+using namespace std::string_view_literals;
+
+constexpr auto a_parser = make_char_parser('a');
+static_assert(a_parser("abc")->first == 'a');
+static_assert(a_parser("abc")->second == "bc"sv);
+static_assert(!a_parser("def"));
+static_assert(!a_parser(""));
+
+static_assert(one_of("xyz")("zap")->first == 'z');
+static_assert(!one_of("xyz")("abc"));
+static_assert(!one_of("xyz")(""));
+static_assert(none_of("xyz")("abc")->first == 'a');
+static_assert(!none_of("xyz")("xbc"));
+
+static_assert(skip_whitespace()("  \t\r\n abc")->second == "abc"sv);
+static_assert(skip_whitespace()("abc")->second == "abc"sv);
+static_assert(skip_whitespace()("   ")->second.empty());
+
+static_assert(int_parser()("1203")->first == 1203);
+static_assert(int_parser()("42 rest")->second == " rest"sv);
+static_assert(!int_parser()("x42"));
+static_assert(int_parser()("0")->first == 0);
+static_assert(int_parser()("007")->first == 7);
+static_assert(int_parser()("-15x")->first == -15);
+static_assert(int_parser()("-15x")->second == "x"sv);
+static_assert(!int_parser()("-"));
+static_assert(int_parser()("2147483647")->first == 2147483647);
+static_assert(!int_parser()("2147483648"));
+static_assert(int_parser()("-2147483648")->first == std::numeric_limits<int>::min());
+static_assert(!int_parser()("-2147483649"));
+static_assert(!int_parser<unsigned>()("-1"));
+static_assert(int_parser<unsigned>()("4294967295")->first == 4294967295u);
+static_assert(int_parser<std::int8_t>()("-128")->first == -128);
+static_assert(!int_parser<std::int8_t>()("00000000128"));
+static_assert(int_parser<std::uint64_t>()("18446744073709551615")->first ==
+              18446744073709551615ull);
+static_assert(!int_parser<std::uint64_t>()("18446744073709551616"));
+static_assert(int_parser<long long>()("1234567812345678;")->first == 1234567812345678ll);
+
+static_assert(string_parser("\"hello\" world")->first == "hello"sv);
+static_assert(string_parser("\"hello\" world")->second == " world"sv);
+static_assert(string_parser("\"\"")->first.empty());
+static_assert(!string_parser("\"unterminated"));
+static_assert(!string_parser(""));
+
+constexpr auto ws_then_int = skip_whitespace() < int_parser();
+static_assert(ws_then_int("   17;")->first == 17);
+static_assert(ws_then_int("   17;")->second == ";"sv);
+
+constexpr auto sum_ints = many(ws_then_int, 0, [](int acc, int v) { return acc + v; });
+static_assert(sum_ints(" 1 2 3\t40\n")->first == 46);
+
+constexpr auto digit_value = fmap([](char c) { return c - '0'; }, one_of(detail::digits));
+static_assert(digit_value("7")->first == 7);
+
+constexpr auto a_or_b = make_char_parser('a') | make_char_parser('b');
+static_assert(a_or_b("bz")->first == 'b');
+static_assert(!a_or_b("cz"));
+
+// runs longer than one 8-byte word go through the SWAR scan
+static_assert(skip_whitespace()(" \t \n \r  \t\t   \n\n x")->second == "x"sv);
+static_assert(skip_whitespace()("        x")->second == "x"sv);
+static_assert(take_while(one_of("ab"))("abababababababbbbaac")->first.size() == 19);
+static_assert(take_while(none_of("\""))("0123456789abcdef\"")->first.size() == 16);
+static_assert(take_while(one_of("0123456789"))("0123456789x")->first.size() == 10);
+static_assert(string_parser("\"a somewhat longer string\" tail")->second == " tail"sv);
+
+// failures know where they happened and what was expected there
+constexpr std::string_view bad_list = "  1 2 x";
+static_assert(error_offset(ws_then_int(bad_list.substr(5)).error(), bad_list) == 6);
+static_assert(ws_then_int(bad_list.substr(5)).error().expected == "integer"sv);
+static_assert(a_parser("b").error().expected == "a"sv);
+static_assert(string_parser("\"open").error().expected == "\""sv);
+static_assert(error_offset(string_parser("\"open").error(), "\"open") == 5);
+static_assert(!int_parser<std::int8_t>()("300"));
+static_assert(int_parser<std::int8_t>()("300").error().expected == "integer in range"sv);
+
+// operator| reports the alternative that got furthest
+constexpr auto pair_or_int = (make_char_parser('(') < int_parser() > make_char_parser(')')) |
+                             int_parser();
+constexpr std::string_view bad_pair = "(12]";
+static_assert(error_offset(pair_or_int(bad_pair).error(), bad_pair) == 3);
+static_assert(pair_or_int(bad_pair).error().expected == ")"sv);
+static_assert(named(int_parser(), "count")("x").error().expected == "count"sv);
+} // namespace
@@ -1,18 +1,140 @@
 #ifndef DRAKMOOR_PARSERS
 #define DRAKMOOR_PARSERS
 
-#include <string_view>
+#include "io/swar.hpp"
+
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <optional>
+#include <string_view>
+#include <system_error>
 #include <variant>
 #include <string>
+#include <type_traits>
+#include <utility>
 
 namespace parsers
 {
 
 using parse_input_t = std::string_view;
 
+// Why a parse failed: the input position it stopped at and what would have
+// been accepted there. `expected` refers to static storage (a literal or the
+// character table below), so failing never allocates. A default constructed
+// error (what `return std::nullopt;` produces) carries no position.
+struct parse_error
+{
+    const char* where = nullptr;
+    std::string_view expected;
+};
+
+// The error that got further into the input; the first one on a tie.
+constexpr const parse_error& furthest(const parse_error& e1, const parse_error& e2)
+{
+    if (e2.where == nullptr) return e1;
+    if (e1.where == nullptr) return e2;
+    return e2.where > e1.where ? e2 : e1;
+}
+
+// Either the parsed value and the remaining input, or a parse_error. Reads
+// like the std::optional<std::pair<T, parse_input_t>> it replaces.
 template <typename T>
-using parse_result_t = std::optional<std::pair<T, std::string_view>>;
+class parse_result
+{
+public:
+    using value_type = std::pair<T, parse_input_t>;
+
+    constexpr parse_result() = default;
+
+    constexpr parse_result(std::nullopt_t)
+    {
+    }
+
+    constexpr parse_result(value_type v) : value(std::move(v))
+    {
+    }
+
+    constexpr parse_result(parse_error e) : failure(e)
+    {
+    }
+
+    constexpr bool has_value() const
+    {
+        return value.has_value();
+    }
+
+    constexpr explicit operator bool() const
+    {
+        return has_value();
+    }
+
+    constexpr value_type& operator*()
+    {
+        return *value;
+    }
+
+    constexpr const value_type& operator*() const
+    {
+        return *value;
+    }
+
+    constexpr value_type* operator->()
+    {
+        return &*value;
+    }
+
+    constexpr const value_type* operator->() const
+    {
+        return &*value;
+    }
+
+    constexpr parse_error error() const
+    {
+        return failure;
+    }
+
+private:
+    std::optional<value_type> value;
+    parse_error failure;
+};
+
+template <typename T>
+using parse_result_t = parse_result<T>;
+
+// Offset of a failure into the input the top-level parser was given.
+constexpr std::size_t error_offset(const parse_error& e, parse_input_t input)
+{
+    return e.where == nullptr ? input.size() : static_cast<std::size_t>(e.where - input.data());
+}
+
+// Human readable report, built only when asked for:
+// "line 3, column 7 (offset 42): expected integer".
+inline std::string describe(const parse_error& e, parse_input_t input)
+{
+    const auto offset = error_offset(e, input);
+    std::size_t line = 1;
+    std::size_t line_start = 0;
+    for (std::size_t i = 0; i < offset && i < input.size(); ++i)
+    {
+        if (input[i] == '\n')
+        {
+            ++line;
+            line_start = i + 1;
+        }
+    }
+    std::string report = "line " + std::to_string(line) + ", column " +
+                         std::to_string(offset - line_start + 1) + " (offset " +
+                         std::to_string(offset) + ")";
+    if (!e.expected.empty())
+    {
+        report += ": expected ";
+        report += e.expected;
+    }
+    return report;
+}
 
 template <typename P>
 using opt_pair_parse_t = std::result_of_t<P(parse_input_t)>;
@@ -21,217 +143,478 @@ using pair_parse_t = typename opt_pair_parse_t<P>::value_type;
 template <typename P>
 using parse_t = typename pair_parse_t<P>::first_type;
 
-auto make_char_parser(char c)
+namespace detail
 {
-    return [=] (parse_input_t s) -> parse_result_t<char>
+// every byte value once, so single characters can be named without storage
+inline constexpr auto char_table = [] {
+    std::array<char, 256> table{};
+    for (std::size_t i = 0; i < table.size(); ++i)
     {
-        if (s.empty() || s[0] != c) return std::nullopt;
+        table[i] = static_cast<char>(i);
+    }
+    return table;
+}();
 
-        return parse_result_t<char>(std::make_pair(c, parse_input_t(s.data()+1, s.size()-1)));
-    };
+constexpr std::string_view char_name(char c)
+{
+    return std::string_view(&char_table[static_cast<unsigned char>(c)], 1);
+}
 }
 
-auto one_of(std::string_view chars)
+// Parses one character out of a fixed set. The set is a 256-bit table, so a
+// test is a single lookup, and runs of the set (see span/skip_many/take_while)
+// are scanned eight bytes at a time whenever the set or its complement has at
+// most four members, which covers whitespace, quotes and delimiters.
+class char_set_parser
 {
-    return [=] (parse_input_t s) -> parse_result_t<char>
+public:
+    constexpr explicit char_set_parser(std::string_view chars, bool negate = false)
+        : expected(negate ? "character not in set" : "character in set")
+    {
+        if (chars.size() == 1 && !negate)
+        {
+            expected = detail::char_name(chars[0]);
+        }
+        for (const char c : chars)
+        {
+            insert(c);
+        }
+        if (negate)
+        {
+            for (auto& word : bits)
+            {
+                word = ~word;
+            }
+        }
+        update_scan_members();
+    }
+
+    constexpr bool contains(char c) const
+    {
+        const auto u = static_cast<unsigned char>(c);
+        return ((bits[u >> 6] >> (u & 63u)) & 1u) != 0;
+    }
+
+    constexpr parse_result_t<char> operator()(parse_input_t s) const
+    {
+        if (s.empty() || !contains(s[0])) return parse_error{s.data(), expected};
+
+        return parse_result_t<char>(std::make_pair(s[0], parse_input_t(s.data()+1, s.size()-1)));
+    }
+
+    // Length of the longest prefix of s made of characters in the set.
+    constexpr std::size_t span(parse_input_t s) const
     {
-        auto j = chars.find(s[0]);
-        if (j != parse_input_t::npos)
+        std::size_t i = 0;
+        if (scan_count != 0)
         {
-            return parse_result_t<char>(std::make_pair(s[0], parse_input_t(s.data()+1, s.size()-1)));
+            for (; i + 8 <= s.size(); i += 8)
+            {
+                std::uint64_t matched = 0;
+                const auto word = io::swar::load_word(s.data() + i);
+                for (std::size_t m = 0; m < scan_count; ++m)
+                {
+                    matched |= io::swar::match_byte(word, scan_members[m]);
+                }
+                // bytes that end the run: outside the set
+                const std::uint64_t stop =
+                    scan_complement ? matched : (~matched & io::swar::high_bits);
+                if (stop != 0)
+                {
+                    return i + static_cast<std::size_t>(io::swar::count_trailing_zeros(stop) / 8);
+                }
+            }
         }
-        return std::nullopt;
+        while (i < s.size() && contains(s[i]))
+        {
+            ++i;
+        }
+        return i;
+    }
+
+    friend constexpr char_set_parser operator|(char_set_parser lhs, char_set_parser rhs)
+    {
+        for (std::size_t i = 0; i < lhs.bits.size(); ++i)
+        {
+            lhs.bits[i] |= rhs.bits[i];
+        }
+        lhs.expected = "character in set";
+        lhs.update_scan_members();
+        return lhs;
+    }
+
+private:
+    constexpr void insert(char c)
+    {
+        const auto u = static_cast<unsigned char>(c);
+        bits[u >> 6] |= std::uint64_t{1} << (u & 63u);
+    }
+
+    // Picks the (at most four) bytes the SWAR scan compares against: the
+    // members of the set, or of its complement. Otherwise span uses the table.
+    constexpr void update_scan_members()
+    {
+        std::size_t members = 0;
+        for (int c = 0; c < 256; ++c)
+        {
+            members += contains(static_cast<char>(c)) ? 1 : 0;
+        }
+        scan_complement = members > scan_members.size();
+        const std::size_t count = scan_complement ? 256 - members : members;
+        scan_count = 0;
+        if (count > scan_members.size()) return;
+        for (int c = 0; c < 256; ++c)
+        {
+            if (contains(static_cast<char>(c)) != scan_complement)
+            {
+                scan_members[scan_count++] = static_cast<unsigned char>(c);
+            }
+        }
+    }
+
+    std::array<std::uint64_t, 4> bits{};
+    std::array<unsigned char, 4> scan_members{};
+    std::size_t scan_count = 0;
+    bool scan_complement = false;
+    std::string_view expected;
+};
+
+constexpr auto make_char_parser(char c)
+{
+    return char_set_parser(std::string_view(&c, 1));
+}
+
+constexpr auto one_of(std::string_view chars)
+{
+    return char_set_parser(chars);
+}
+
+constexpr auto none_of(std::string_view chars)
+{
+    return char_set_parser(chars, true);
+}
+
+// zero or more characters of the set, discarding them
+constexpr auto skip_many(char_set_parser p)
+{
+    return [p] (parse_input_t s) -> parse_result_t<std::monostate>
+    {
+        const auto n = p.span(s);
+        return parse_result_t<std::monostate>(
+            std::make_pair(std::monostate{}, parse_input_t(s.data()+n, s.size()-n)));
     };
 }
 
-auto none_of(std::string_view chars)
+// zero or more characters of the set, returning them as a view of the input
+constexpr auto take_while(char_set_parser p)
 {
-    return [=] (parse_input_t s) -> parse_result_t<char>
+    return [p] (parse_input_t s) -> parse_result_t<std::string_view>
     {
-        auto j = chars.find(s[0]);
-        if (j == parse_input_t::npos)
-        {
-            return parse_result_t<char>(std::make_pair(s[0], parse_input_t(s.data()+1, s.size()-1)));
-        }
-        return std::nullopt;
+        const auto n = p.span(s);
+        return parse_result_t<std::string_view>(
+            std::make_pair(s.substr(0, n), parse_input_t(s.data()+n, s.size()-n)));
     };
 }
 
 template <typename F, typename P>
-auto fmap(F&& f, P&& p)
+constexpr auto fmap(F&& f, P&& p)
 {
     using R = parse_result_t<std::result_of_t<F(parse_t<P>)>>;
     return [f = std::forward<F>(f),
             p = std::forward<P>(p)] (parse_input_t i) -> R
            {
-               const auto r = p(i);
-               if (!r) return std::nullopt;
-               return R(std::make_pair(f(r->first), r->second));
+               auto r = p(i);
+               if (!r) return r.error();
+               return R(std::make_pair(f(std::move(r->first)), r->second));
            };
 }
 
 template <typename P, typename F>
-auto bind(P&& p, F&& f)
+constexpr auto bind(P&& p, F&& f)
 {
     using R = std::result_of_t<F(parse_t<P>, parse_input_t)>;
-    return [=] (parse_input_t i) -> R
+    return [p = std::forward<P>(p),
+            f = std::forward<F>(f)] (parse_input_t i) -> R
            {
-               const auto r = p(i);
-               if (!r) return std::nullopt;
-               return f(r->first, r->second);
+               auto r = p(i);
+               if (!r) return r.error();
+               return f(std::move(r->first), r->second);
            };
 }
 
 template <typename P1, typename P2, std::enable_if_t<std::is_same_v<parse_t<P1>, parse_t<P2>>, int> = 0>
-auto operator|(P1&& p1, P2&& p2)
+constexpr auto operator|(P1&& p1, P2&& p2)
 {
-    return [=](parse_input_t i)
+    return [p1 = std::forward<P1>(p1),
+            p2 = std::forward<P2>(p2)] (parse_input_t i)
            {
-               const auto r1 = p1(i);
+               auto r1 = p1(i);
                if (r1) return r1;
-               return p2(i);
+               auto r2 = p2(i);
+               if (r2) return r2;
+               return decltype(r2)(furthest(r1.error(), r2.error()));
+           };
+}
+
+// p, reporting `expected` (a string with static storage) when it fails
+template <typename P>
+constexpr auto named(P&& p, std::string_view expected)
+{
+    return [p = std::forward<P>(p), expected] (parse_input_t i)
+           {
+               auto r = p(i);
+               if (!r)
+               {
+                   const auto where = r.error().where;
+                   return decltype(r)(parse_error{where != nullptr ? where : i.data(), expected});
+               }
+               return r;
            };
 }
 
 template <typename T>
-auto fail(T)
+constexpr auto fail(T)
 {
-    return [=] (parse_input_t) -> parse_result_t<T>
+    return [] (parse_input_t i) -> parse_result_t<T>
     {
-        return std::nullopt;
+        return parse_error{i.data(), "nothing"};
     };
 }
 
 template <typename P1, typename P2, typename F,
           typename R = std::result_of_t<F(parse_t<P1>, parse_t<P2>)>>
-auto combine(P1&& p1, P2&& p2, F&& f)
+constexpr auto combine(P1&& p1, P2&& p2, F&& f)
 {
-    return [=] (parse_input_t i) -> parse_result_t<R>
+    return [p1 = std::forward<P1>(p1),
+            p2 = std::forward<P2>(p2),
+            f = std::forward<F>(f)] (parse_input_t i) -> parse_result_t<R>
     {
-        const auto r1 = p1(i);
-        if (!r1) return std::nullopt;
-        const auto r2 = p2(r1->second);
-        if (!r2) return std::nullopt;
+        auto r1 = p1(i);
+        if (!r1) return r1.error();
+        auto r2 = p2(r1->second);
+        if (!r2) return r2.error();
 
-        return parse_result_t<R>(std::make_pair(f(r1->first, r2->first), r2->second));
+        return parse_result_t<R>(std::make_pair(
+            f(std::move(r1->first), std::move(r2->first)), r2->second));
     };
 }
 
 template <typename P1, typename P2,
           typename = parse_t<P1>, typename = parse_t<P2>>
-auto operator<(P1&& p1, P2&& p2)
+constexpr auto operator<(P1&& p1, P2&& p2)
 {
     return combine(std::forward<P1>(p1),
                    std::forward<P2>(p2),
-                   [] (auto, const auto& r) { return r; });
+                   [] (auto, auto r) { return r; });
 }
 
 template <typename P1, typename P2,
           typename = parse_t<P1>, typename = parse_t<P2>>
-auto operator>(P1&& p1, P2&& p2)
+constexpr auto operator>(P1&& p1, P2&& p2)
 {
     return combine(std::forward<P1>(p1),
                    std::forward<P2>(p2),
-                   [] (const auto& l, auto) { return l; });
+                   [] (auto l, auto) { return l; });
 }
 
 namespace detail
 {
+// The accumulator is threaded through f by move, so containers grow in place
+// instead of being copied once per token.
 template <typename P, typename T, typename F>
-std::pair<T, parse_input_t> accumulate_parse(
+constexpr std::pair<T, parse_input_t> accumulate_parse(
     parse_input_t s, P&& p, T init, F&& f)
 {
     while (!s.empty()) {
-        const auto r = p(s);
-        if (!r) return std::make_pair(init, s);
-        init = f(init, r->first);
+        auto r = p(s);
+        if (!r) break;
+        init = f(std::move(init), std::move(r->first));
         s = r->second;
     }
-    return std::make_pair(init, s);
+    return std::pair<T, parse_input_t>(std::move(init), s);
 }
 
 template <typename P, typename T, typename F>
-std::pair<T, parse_input_t> accumulate_n_parse(
+constexpr std::pair<T, parse_input_t> accumulate_n_parse(
     parse_input_t s, P&& p, std::size_t n, T init, F&& f)
 {
     while (n != 0) {
-        const auto r = p(s);
-        if (!r) return std::make_pair(init, s);
-        init = f(init, r->first);
+        auto r = p(s);
+        if (!r) break;
+        init = f(std::move(init), std::move(r->first));
         s = r->second;
         --n;
     }
-    return std::make_pair(init, s);
+    return std::pair<T, parse_input_t>(std::move(init), s);
 }
 }
 
 // apply * (zero or more) of a parser, accumulating the results according to a
 // function F. F :: T -> (parse_t<P>, parse_input_t) -> T
 template <typename P, typename T, typename F>
-auto many(P&& p, T&& init, F&& f)
+constexpr auto many(P&& p, T&& init, F&& f)
 {
+    using U = std::decay_t<T>;
     return [p = std::forward<P>(p),
            init = std::forward<T>(init),
            f = std::forward<F>(f)] (parse_input_t s)
            {
-               return parse_result_t<T>(
-                   detail::accumulate_parse(s, p, init, f));
+               return parse_result_t<U>(
+                   detail::accumulate_parse(s, p, U(init), f));
            };
 }
 
 // apply + (one or more) of a parser, accumulating the results according to a
 // function F. F :: T -> (parse_t<P>, parse_input_t) -> T
 template <typename P, typename T, typename F>
-auto many1(P&& p, T&& init, F&& f)
+constexpr auto many1(P&& p, T&& init, F&& f)
 {
+    using U = std::decay_t<T>;
     return [p = std::forward<P>(p),
            init = std::forward<T>(init),
-           f = std::forward<F>(f)] (parse_input_t s) -> parse_result_t<T>
+           f = std::forward<F>(f)] (parse_input_t s) -> parse_result_t<U>
     {
-        const auto r = p(s);
-        if (!r) return std::nullopt;
-        return parse_result_t<T>(
-            detail::accumulate_parse(r->second, p, f(init, r->first), f));
+        auto r = p(s);
+        if (!r) return r.error();
+        return parse_result_t<U>(detail::accumulate_parse(
+            r->second, p, f(U(init), std::move(r->first)), f));
     };
 }
 
-auto skip_whitespace()
+constexpr auto skip_whitespace()
 {
+    // the alternatives collapse into a single char_set_parser
     auto ws_parser =
         make_char_parser(' ')
         | make_char_parser('\t')
         | make_char_parser('\n')
         | make_char_parser('\r');
-    return many(ws_parser, std::monostate{}, [](auto m, auto) { return m; });
+    return skip_many(ws_parser);
 }
 
-auto int_parser()
+namespace detail
 {
-    using namespace std::string_view_literals;
+inline constexpr std::string_view digits = "0123456789";
+
+constexpr bool is_digit(char c)
+{
+    return c >= '0' && c <= '9';
+}
 
-    static constexpr auto digits = "0123456789"sv;
-    static constexpr auto non_zero_digits = "123456789"sv;
+constexpr bool all_digits(std::uint64_t word)
+{
+    return (word & 0xF0F0F0F0F0F0F0F0ull) == 0x3030303030303030ull &&
+           ((word + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) ==
+               0x3030303030303030ull;
+}
 
-    return bind(one_of(non_zero_digits),
-                [] (char x, parse_input_t rest)
-                {
-                    return many(one_of(digits),
-                                static_cast<int>(x - '0'),
-                                [] (int acc, char c) { return (acc*10) + (c - '0'); })(rest);
-                });
+// Value of eight ASCII digits loaded with io::swar::load_word (first digit in
+// the low byte), combining neighbouring digits pairwise in three multiply steps.
+constexpr std::uint64_t eight_digits_value(std::uint64_t word)
+{
+    word -= 0x3030303030303030ull;
+    word = (word * 10) + (word >> 8);
+    return (((word & 0x000000FF000000FFull) * (100 + (1000000ull << 32))) +
+            (((word >> 16) & 0x000000FF000000FFull) * (1 + (10000ull << 32)))) >>
+           32;
+}
+
+// Accumulates the decimal digits at the front of s into value without ever
+// exceeding limit. Returns the number of digits consumed, or npos on overflow.
+constexpr std::size_t accumulate_digits(parse_input_t s, std::uint64_t limit,
+                                        std::uint64_t& value)
+{
+    // Up to 19 digits fit in 64 bits, so only longer runs need checks
+    // while accumulating.
+    std::size_t i = 0;
+    for (; i < 16 && i + 8 <= s.size(); i += 8)
+    {
+        const auto word = io::swar::load_word(s.data() + i);
+        if (!all_digits(word)) break;
+        value = value * 100000000u + eight_digits_value(word);
+    }
+    for (; i < 19 && i < s.size() && is_digit(s[i]); ++i)
+    {
+        value = value * 10 + static_cast<std::uint64_t>(s[i] - '0');
+    }
+    for (; i < s.size() && is_digit(s[i]); ++i)
+    {
+        const auto digit = static_cast<std::uint64_t>(s[i] - '0');
+        if (value > (std::numeric_limits<std::uint64_t>::max() - digit) / 10)
+        {
+            return parse_input_t::npos;
+        }
+        value = value * 10 + digit;
+    }
+    return value > limit ? parse_input_t::npos : i;
+}
+}
+
+// Decimal integer of type T: an optional '-' (signed T only) followed by one
+// or more digits. Fails instead of wrapping when the value does not fit in T.
+// Runs of eight digits are converted at once.
+template <typename T = int>
+constexpr auto int_parser()
+{
+    static_assert(std::is_integral_v<T> && sizeof(T) <= sizeof(std::uint64_t));
+
+    return [] (parse_input_t s) -> parse_result_t<T>
+    {
+        bool negative = false;
+        if constexpr (std::is_signed_v<T>)
+        {
+            negative = !s.empty() && s[0] == '-';
+        }
+        const auto digits = s.substr(negative ? 1 : 0);
+
+        constexpr auto max = static_cast<std::uint64_t>(std::numeric_limits<T>::max());
+        std::uint64_t magnitude = 0;
+        const auto n = detail::accumulate_digits(digits, negative ? max + 1 : max, magnitude);
+        if (n == 0) return parse_error{s.data(), "integer"};
+        if (n == parse_input_t::npos) return parse_error{s.data(), "integer in range"};
+
+        T value{};
+        if (negative)
+        {
+            // -(max + 1) is representable, its magnitude as a T is not
+            value = magnitude == max + 1 ? std::numeric_limits<T>::min()
+                                         : static_cast<T>(-static_cast<T>(magnitude));
+        }
+        else
+        {
+            value = static_cast<T>(magnitude);
+        }
+        return parse_result_t<T>(std::make_pair(value, digits.substr(n)));
+    };
+}
+
+// Floating-point number of type T in the syntax std::from_chars accepts
+// (general format, no leading '+'), correctly rounded. Values out of T's range
+// fail. Not usable in constant expressions.
+template <typename T = double>
+constexpr auto float_parser()
+{
+    static_assert(std::is_floating_point_v<T>);
+
+    return [] (parse_input_t s) -> parse_result_t<T>
+    {
+        T value{};
+        const auto [end, ec] = std::from_chars(s.data(), s.data() + s.size(), value);
+        if (ec == std::errc::result_out_of_range)
+        {
+            return parse_error{s.data(), "number in range"};
+        }
+        if (ec != std::errc{}) return parse_error{s.data(), "number"};
+        const auto n = static_cast<std::size_t>(end - s.data());
+        return parse_result_t<T>(std::make_pair(value, s.substr(n)));
+    };
 }
 
-auto string_parser(parse_input_t s)
+constexpr auto string_parser(parse_input_t s)
 {
     using namespace std::string_view_literals;
     const auto quote_parser = make_char_parser('"');
-    const auto str_parser =
-        many(none_of("\""sv),
-             std::string_view(s.data() + 1, 0),
-             [] (const auto& acc, auto)
-             {
-                 return std::string_view(acc.data(), acc.size()+1);
-             });
+    const auto str_parser = take_while(none_of("\""sv));
 
     return (quote_parser < str_parser > quote_parser)(s);
 }
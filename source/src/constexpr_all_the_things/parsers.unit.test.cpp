@@ -0,0 +1,406 @@
+#include "packrat.hpp"
+#include "parsers.hpp"
+#include "stream.hpp"
+
+#include <catch.hpp>
+
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+
+using namespace parsers;
+
+namespace
+{
+// byte-at-a-time reference for char_set_parser::span
+std::size_t reference_span(std::string_view chars, bool negate, std::string_view s)
+{
+    std::size_t i = 0;
+    while (i < s.size() && ((chars.find(s[i]) != std::string_view::npos) != negate))
+    {
+        ++i;
+    }
+    return i;
+}
+
+std::string random_string(std::mt19937& gen, std::string_view alphabet, std::size_t size)
+{
+    std::uniform_int_distribution<std::size_t> pick{0, alphabet.size() - 1};
+    std::string s;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        s += alphabet[pick(gen)];
+    }
+    return s;
+}
+}
+
+TEST_CASE("char set scans agree with byte-at-a-time parsing", "[char_set]")
+{
+    const std::string_view sets[] = {" \t\n\r", "\"", "ab", "0123456789", "x"};
+    const std::string alphabet = " \t\n\r\"abx0123456789\x80\xff";
+
+    std::mt19937 gen{7};
+    std::uniform_int_distribution<std::size_t> length{0, 40};
+    for (int round = 0; round < 2000; ++round)
+    {
+        const auto input = random_string(gen, alphabet, length(gen));
+        for (const auto chars : sets)
+        {
+            REQUIRE(one_of(chars).span(input) == reference_span(chars, false, input));
+            REQUIRE(none_of(chars).span(input) == reference_span(chars, true, input));
+        }
+    }
+}
+
+TEST_CASE("skip_whitespace stops at the first non-blank byte", "[char_set]")
+{
+    for (std::size_t blanks = 0; blanks < 33; ++blanks)
+    {
+        const auto input = std::string(blanks, ' ') + "\x80rest";
+        const auto r = skip_whitespace()(input);
+        REQUIRE(r);
+        REQUIRE(r->second.size() == 5);
+    }
+}
+
+TEST_CASE("alternatives of char parsers merge into one set", "[char_set]")
+{
+    const auto p = make_char_parser('a') | one_of("bc") | none_of("abcdefghijklmnopqrstuvwxyz");
+    static_assert(std::is_same_v<decltype(p), const char_set_parser>);
+
+    REQUIRE(p("a"));
+    REQUIRE(p("c"));
+    REQUIRE(p("Z"));
+    REQUIRE(!p("d"));
+    REQUIRE(!p(""));
+}
+
+TEST_CASE("int_parser agrees with from_chars", "[numbers]")
+{
+    std::mt19937_64 gen{11};
+    for (int round = 0; round < 20000; ++round)
+    {
+        const auto v = static_cast<long long>(gen());
+        const auto text = std::to_string(v >> (round % 64)) + " ";
+
+        const auto r = int_parser<long long>()(text);
+        long long expected = 0;
+        std::from_chars(text.data(), text.data() + text.size(), expected);
+        REQUIRE(r);
+        REQUIRE(r->first == expected);
+        REQUIRE(r->second == " ");
+
+        const auto narrow = int_parser<int>()(text);
+        const bool fits = expected >= std::numeric_limits<int>::min() &&
+                          expected <= std::numeric_limits<int>::max();
+        REQUIRE(static_cast<bool>(narrow) == fits);
+    }
+}
+
+TEST_CASE("float_parser", "[numbers]")
+{
+    const auto p = float_parser<double>();
+
+    REQUIRE(p("3.25rest")->first == Approx(3.25));
+    REQUIRE(p("3.25rest")->second == "rest");
+    REQUIRE(p("-1e-3")->first == Approx(-1e-3));
+    REQUIRE(!p("x1.0"));
+    REQUIRE(!p(""));
+    REQUIRE(!p("1e400"));
+    REQUIRE(!float_parser<float>()("1e39"));
+    REQUIRE(float_parser<float>()("1e38"));
+}
+
+TEST_CASE("float_parser rounds like strtod", "[numbers]")
+{
+    std::mt19937_64 gen{13};
+    std::uniform_real_distribution<double> mantissa{-1.0, 1.0};
+    std::uniform_int_distribution<int> exponent{-300, 300};
+    for (int round = 0; round < 20000; ++round)
+    {
+        char text[64];
+        std::snprintf(text, sizeof(text), "%.*g", 1 + round % 17,
+                      std::ldexp(mantissa(gen), exponent(gen)));
+
+        const auto r = float_parser<double>()(text);
+        const double expected = std::strtod(text, nullptr);
+        REQUIRE(r);
+        REQUIRE(std::memcmp(&r->first, &expected, sizeof(double)) == 0);
+    }
+}
+
+TEST_CASE("errors are described on request", "[errors]")
+{
+    const std::string input = "1 2 3\n4 5 six";
+    const auto token = skip_whitespace() < int_parser();
+    const auto three = token > token > token;
+
+    const auto r = (three < three)(input);
+    REQUIRE(!r);
+    REQUIRE(error_offset(r.error(), input) == 10);
+    REQUIRE(describe(r.error(), input) == "line 2, column 5 (offset 10): expected integer");
+}
+
+namespace
+{
+// s := '(' s ')' 'x' | '(' s ')' 'y' | 'a'
+// Without memoization the second alternative re-parses the nested s, so
+// "((a)y)y" style inputs take time exponential in the nesting depth.
+struct nested
+{
+    memo_table* table = nullptr;
+    int* calls = nullptr;
+
+    parse_result<int> operator()(parse_input_t i) const
+    {
+        ++*calls;
+        const auto self = [this](parse_input_t in) { return parse(in); };
+        const auto wrapped = make_char_parser('(') < fmap([](int depth) { return depth + 1; },
+                                                          self) > make_char_parser(')');
+        const auto leaf = fmap([](char) { return 0; }, make_char_parser('a'));
+        return ((wrapped > make_char_parser('x')) | (wrapped > make_char_parser('y')) | leaf)(i);
+    }
+
+    parse_result<int> parse(parse_input_t i) const
+    {
+        if (table == nullptr) return (*this)(i);
+        return memoize(1, *this, *table)(i);
+    }
+};
+
+std::string nested_input(int depth)
+{
+    return std::string(static_cast<std::size_t>(depth), '(') + "a" +
+           [depth] {
+               std::string tail;
+               for (int i = 0; i < depth; ++i) tail += ")y";
+               return tail;
+           }();
+}
+}
+
+TEST_CASE("memoization makes nested alternatives linear", "[packrat]")
+{
+    const auto input = nested_input(12);
+
+    int plain_calls = 0;
+    const auto plain = nested{nullptr, &plain_calls}.parse(input);
+
+    memo_table table(input);
+    int memo_calls = 0;
+    const auto memoized = nested{&table, &memo_calls}.parse(input);
+
+    REQUIRE(plain);
+    REQUIRE(memoized);
+    REQUIRE(plain->first == 12);
+    REQUIRE(memoized->first == 12);
+    REQUIRE(memoized->second.empty());
+    REQUIRE(plain_calls > 4000);
+    REQUIRE(memo_calls == 13);
+    REQUIRE(table.hits() == 12);
+}
+
+TEST_CASE("memoization respects the memory bound", "[packrat]")
+{
+    const auto input = nested_input(8);
+
+    memo_table table(input, 0);
+    int calls = 0;
+    const auto r = nested{&table, &calls}.parse(input);
+
+    REQUIRE(r);
+    REQUIRE(r->first == 8);
+    REQUIRE(table.entries() == 0);
+    REQUIRE(table.bytes_used() == 0);
+}
+
+TEST_CASE("memoized results may own memory", "[packrat]")
+{
+    const std::string input = "abcabc";
+    memo_table table(input);
+    const auto word = memoize(7, fmap([](std::string_view v) { return std::string(v); },
+                                      take_while(one_of("abc"))),
+                              table);
+
+    REQUIRE(word(input)->first == "abcabc");
+    REQUIRE(word(input)->first == "abcabc");
+    REQUIRE(table.hits() == 1);
+}
+
+TEST_CASE("memoized results are not reused for a shorter view", "[packrat]")
+{
+    const std::string input = "abcabc";
+    const std::string_view whole = input;
+    memo_table table(whole);
+    const auto word = memoize(7, take_while(one_of("abc")), table);
+
+    REQUIRE(word(whole)->first == "abcabc");
+    REQUIRE(word(whole.substr(0, 3))->first == "abc");
+    REQUIRE(word(whole.substr(3))->first == "abc");
+    REQUIRE(word(whole.substr(3, 1))->first == "a");
+    REQUIRE(table.hits() == 0);
+    REQUIRE(table.entries() == 4);
+
+    REQUIRE(word(whole.substr(0, 3))->first == "abc");
+    REQUIRE(table.hits() == 1);
+}
+
+namespace
+{
+// a temporary file holding `content`, removed again on destruction
+struct temp_file
+{
+    explicit temp_file(const std::string& content)
+    {
+        char name[] = "/tmp/catf-stream-XXXXXX";
+        fd = ::mkstemp(name);
+        path = name;
+        REQUIRE(::write(fd, content.data(), content.size()) ==
+                static_cast<ssize_t>(content.size()));
+        ::lseek(fd, 0, SEEK_SET);
+    }
+
+    ~temp_file()
+    {
+        ::close(fd);
+        ::unlink(path.c_str());
+    }
+
+    int fd = -1;
+    std::string path;
+};
+
+std::string numbers_text(int count)
+{
+    std::string text = "  ";
+    for (int i = 1; i <= count; ++i)
+    {
+        text += std::to_string(i * 7919);
+        text += i % 10 == 0 ? "\n" : " \t";
+    }
+    return text;
+}
+}
+
+TEST_CASE("streaming parse across buffer boundaries", "[stream]")
+{
+    const auto text = numbers_text(20000);
+    const temp_file file(text);
+    const auto record = skip_whitespace() < int_parser<long long>() > skip_whitespace();
+
+    long long expected = 0;
+    for (long long i = 1; i <= 20000; ++i) expected += i * 7919;
+
+    SECTION("read()")
+    {
+        read_source source(file.fd, 61);
+        long long sum = 0;
+        const auto status = for_each_parse(source, record, [&](long long v) { sum += v; });
+        REQUIRE(status.ok);
+        REQUIRE(status.records == 20000);
+        REQUIRE(sum == expected);
+    }
+
+    SECTION("mmap")
+    {
+        mmap_source source(file.path.c_str(), 61, 4096);
+        long long sum = 0;
+        const auto status = for_each_parse(source, record, [&](long long v) { sum += v; });
+        REQUIRE(status.ok);
+        REQUIRE(status.records == 20000);
+        REQUIRE(sum == expected);
+    }
+}
+
+TEST_CASE("streaming parse reports errors with stream offsets", "[stream]")
+{
+    const std::string text = numbers_text(1000) + " oops 12";
+    const temp_file file(text);
+    const auto record = skip_whitespace() < int_parser() > skip_whitespace();
+
+    read_source source(file.fd, 32);
+    const auto status = for_each_parse(source, record, [](int) {});
+    REQUIRE(!status.ok);
+    REQUIRE(status.records == 1000);
+    REQUIRE(status.offset == text.find("oops"));
+    REQUIRE(status.expected == "integer");
+}
+
+TEST_CASE("streaming parse refuses records larger than the buffer", "[stream]")
+{
+    const temp_file file("1 2 \"a string longer than the buffer\" 3");
+    const auto record = skip_whitespace() < (fmap([](int) { return 0; }, int_parser()) |
+                                             fmap([](auto) { return 1; },
+                                                  named(string_parser, "string"))) >
+                        skip_whitespace();
+
+    read_source source(file.fd, 16);
+    const auto status = for_each_parse(source, record, [](int) {});
+    REQUIRE(!status.ok);
+    REQUIRE(status.records == 2);
+    REQUIRE(status.offset == 4);
+}
+
+TEST_CASE("streaming parse re-reads numbers cut at a sign or an exponent", "[stream]")
+{
+    // Shift the numbers against the 16-byte window edges; the padding is part
+    // of the first record, which has to fit the buffer
+    for (std::size_t pad = 0; pad < 8; ++pad)
+    {
+        SECTION("negative ints, pad " + std::to_string(pad))
+        {
+            std::string text(pad, ' ');
+            long long expected = 0;
+            for (int i = 1; i <= 500; ++i)
+            {
+                text += "-" + std::to_string(i) + " ";
+                expected -= i;
+            }
+            const temp_file file(text);
+            const auto record = skip_whitespace() < int_parser<long long>() > skip_whitespace();
+
+            read_source source(file.fd, 16);
+            long long sum = 0;
+            const auto status = for_each_parse(source, record, [&](long long v) { sum += v; });
+            REQUIRE(status.ok);
+            REQUIRE(status.records == 500);
+            REQUIRE(sum == expected);
+        }
+
+        SECTION("exponent floats, pad " + std::to_string(pad))
+        {
+            std::string text(pad, ' ');
+            for (int i = 1; i <= 500; ++i)
+            {
+                text += std::to_string(i % 9 + 1) + "e" + std::to_string(i % 5) + " -2.5e-1 ";
+            }
+            const temp_file file(text);
+            const auto record =
+                skip_whitespace() < float_parser<double>() > skip_whitespace();
+
+            read_source source(file.fd, 16);
+            std::size_t records = 0;
+            double sum = 0;
+            const auto status = for_each_parse(source, record, [&](double v) {
+                ++records;
+                sum += v;
+            });
+            REQUIRE(status.ok);
+            REQUIRE(status.records == 1000);
+            REQUIRE(records == 1000);
+
+            double expected = 0;
+            for (int i = 1; i <= 500; ++i)
+            {
+                expected += (i % 9 + 1) * std::pow(10.0, i % 5) - 0.25;
+            }
+            REQUIRE(sum == Approx(expected));
+        }
+    }
+}
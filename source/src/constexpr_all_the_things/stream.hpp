@@ -0,0 +1,250 @@
+#ifndef DRAKMOOR_STREAM
+#define DRAKMOOR_STREAM
+
+#include "parsers.hpp"
+
+#include "io/mapped_file.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <system_error>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace parsers
+{
+
+// Input sources for parsing data that is not in memory as a whole. A source
+// exposes a window of contiguous bytes starting at offset(); consume(n) drops
+// bytes from its front and fill() makes it longer. fill() returns false when
+// nothing more can be added: either the input is exhausted (at_end()) or the
+// window has reached the source's memory bound.
+
+// Reads through a fixed-size buffer with read(2). Works for files, pipes and
+// sockets; memory use is the buffer size.
+class read_source
+{
+public:
+    explicit read_source(int fd_init, std::size_t capacity_init = std::size_t{1} << 20)
+        : fd(fd_init), capacity(capacity_init), buffer(new char[capacity_init])
+    {
+    }
+
+    parse_input_t window() const
+    {
+        return parse_input_t(buffer.get() + begin, end - begin);
+    }
+
+    std::uint64_t offset() const
+    {
+        return consumed;
+    }
+
+    void consume(std::size_t n)
+    {
+        begin += n;
+        consumed += n;
+    }
+
+    bool at_end() const
+    {
+        return eof;
+    }
+
+    bool fill()
+    {
+        if (eof) return false;
+        if (begin != 0)
+        {
+            std::memmove(buffer.get(), buffer.get() + begin, end - begin);
+            end -= begin;
+            begin = 0;
+        }
+        if (end == capacity) return false;
+
+        for (;;)
+        {
+            const auto n = ::read(fd, buffer.get() + end, capacity - end);
+            if (n > 0)
+            {
+                end += static_cast<std::size_t>(n);
+                return true;
+            }
+            if (n == 0)
+            {
+                eof = true;
+                return false;
+            }
+            if (errno != EINTR)
+            {
+                throw std::system_error(errno, std::generic_category(), "read");
+            }
+        }
+    }
+
+private:
+    int fd;
+    std::size_t capacity;
+    std::unique_ptr<char[]> buffer;
+    std::size_t begin = 0;
+    std::size_t end = 0;
+    std::uint64_t consumed = 0;
+    bool eof = false;
+};
+
+// Maps a whole file read-only with io::mapped_file and parses it in place. The
+// window grows in steps of `step` bytes up to `max_window`; pages behind the
+// window are released as they are consumed, so resident memory stays around
+// the window size even for files much larger than RAM.
+class mmap_source
+{
+public:
+    explicit mmap_source(const char* path, std::size_t step_init = std::size_t{1} << 20,
+                         std::size_t max_window_init = std::size_t{64} << 20)
+        : file(path), step(step_init), max_window(max_window_init)
+    {
+        length = std::min(step, file.size());
+    }
+
+    parse_input_t window() const
+    {
+        return parse_input_t(file.begin() + position, length);
+    }
+
+    std::uint64_t offset() const
+    {
+        return position;
+    }
+
+    void consume(std::size_t n)
+    {
+        const auto size = file.size();
+        position += n;
+        length = std::min(std::max(length - n, std::min(step, size - position)), size - position);
+        release_consumed_pages();
+    }
+
+    bool at_end() const
+    {
+        return position + length == file.size();
+    }
+
+    bool fill()
+    {
+        const auto grown = std::min({length + step, file.size() - position, max_window});
+        if (grown == length) return false;
+        length = grown;
+        return true;
+    }
+
+private:
+    void release_consumed_pages()
+    {
+        static const auto page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        const auto boundary = position / page * page;
+        if (boundary >= released + step)
+        {
+            ::madvise(const_cast<char*>(file.begin()) + released, boundary - released,
+                      MADV_DONTNEED);
+            released = boundary;
+        }
+    }
+
+    io::mapped_file file;
+    std::size_t position = 0;
+    std::size_t length = 0;
+    std::size_t released = 0;
+    std::size_t step;
+    std::size_t max_window;
+};
+
+struct stream_status
+{
+    bool ok = true;
+    std::uint64_t records = 0;
+    // for failures: absolute offset into the stream and what was expected there
+    std::uint64_t offset = 0;
+    std::string_view expected;
+};
+
+// Top-level `many` over a source: parses records with p one after another and
+// hands each value to on_record as soon as it is parsed, so nothing
+// accumulates. Until the source is exhausted, a record may be cut off by the
+// buffer boundary, and a parser may then fail before the boundary (int_parser
+// at a trailing '-') or succeed on a shorter record ("3" of "3e2"). So a
+// failure, a record that leaves no input behind and a record whose successor
+// fails all make the window grow, and the record is parsed again from its
+// start. Once the window cannot grow, a failure at its end means the record
+// does not fit the buffer and any other failure is reported as it is.
+// p should consume the separators following a record, e.g.
+// skip_whitespace() < int_parser() > skip_whitespace().
+template <typename Source, typename P, typename F>
+stream_status for_each_parse(Source& source, P&& p, F&& on_record)
+{
+    stream_status status;
+    // The record after the last one taken, parsed to confirm it
+    parse_result<parse_t<P>> ahead;
+    parse_input_t ahead_input;
+    for (;;)
+    {
+        const auto w = source.window();
+        if (w.empty())
+        {
+            if (source.fill()) continue;
+            if (source.at_end()) return status;
+        }
+
+        const bool parsed_ahead = w.data() == ahead_input.data() && w.size() == ahead_input.size();
+        auto r = parsed_ahead ? std::move(ahead) : p(w);
+        ahead_input = parse_input_t();
+        const bool complete = source.at_end();
+        const auto* window_end = w.data() + w.size();
+
+        if (r && (!r->second.empty() || complete))
+        {
+            if (r->second.size() == w.size())
+            {
+                // no progress: stop instead of producing the same record forever
+                status.ok = false;
+                status.offset = source.offset();
+                status.expected = "progress";
+                return status;
+            }
+            if (!complete)
+            {
+                ahead = p(r->second);
+                if (!ahead && (source.fill() || source.at_end())) continue;
+                ahead_input = r->second;
+            }
+            source.consume(w.size() - r->second.size());
+            on_record(std::move(r->first));
+            ++status.records;
+            continue;
+        }
+
+        if (!complete && (source.fill() || source.at_end())) continue;
+
+        const auto e = r.error();
+        if (!complete && (r || e.where == nullptr || e.where == window_end))
+        {
+            status.ok = false;
+            status.offset = source.offset();
+            status.expected = "record that fits the buffer";
+            return status;
+        }
+
+        status.ok = false;
+        status.offset = source.offset() + error_offset(e, w);
+        status.expected = e.expected;
+        return status;
+    }
+}
+
+}
+
+#endif // DRAKMOOR_STREAM
@@ -0,0 +1,214 @@
+// Hessian-vector products from symbolic derivatives against numeric ones.
+//
+//   drakmoor-bench [variables] [points]
+//
+// Builds the extended Rosenbrock function of `variables` (default 64)
+// variables and takes its Hessian-vector product at `points` (default 200)
+// random points and directions three ways: evaluating the product built by
+// hessian_vector_product, evaluating the full symbolic Hessian and
+// multiplying, and nesting central differences of the function. Reports the
+// distinct nodes evaluated, the build time and the time per product, and
+// fails when the results disagree. Configure with -DCMAKE_BUILD_TYPE=Release
+// for meaningful numbers.
+#include "derivative.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+using namespace drakmoor;
+using seconds = std::chrono::duration<double>;
+
+// sum over i of (1 - x_i)^2 + 100 (x_{i+1} - x_i^2)^2
+expression rosenbrock(const std::vector<std::string>& variables)
+{
+    expression f{0.0};
+    for (std::size_t i = 0; i + 1 < variables.size(); ++i)
+    {
+        const expression x{variables[i]};
+        const expression next{variables[i + 1]};
+        const auto a = expression{1.0} - x;
+        const auto b = next - x * x;
+        f = f + a * a + expression{100.0} * b * b;
+    }
+    return f;
+}
+
+std::string direction_of(const std::string& variable)
+{
+    return "v" + variable;
+}
+
+// The gradient of f by central differences, moving one variable at a time
+void numeric_gradient(dag_evaluator& f, arg_map& point,
+                      const std::vector<std::string>& variables, std::vector<base_type>& out)
+{
+    constexpr base_type step = 1e-3;
+    for (std::size_t i = 0; i < variables.size(); ++i)
+    {
+        auto& x = point.at(variables[i]);
+        const auto saved = x;
+        x = saved + step;
+        const auto up = f.eval_at(point)[0];
+        x = saved - step;
+        const auto down = f.eval_at(point)[0];
+        x = saved;
+        out[i] = (up - down) / (2 * step);
+    }
+}
+
+// Hv by central differences of the numeric gradient along v
+std::vector<base_type> numeric_product(dag_evaluator& f, arg_map point,
+                                       const std::vector<std::string>& variables)
+{
+    constexpr base_type step = 1e-3;
+    std::vector<base_type> up(variables.size());
+    std::vector<base_type> down(variables.size());
+
+    for (const auto& variable : variables)
+    {
+        point.at(variable) += step * point.at(direction_of(variable));
+    }
+    numeric_gradient(f, point, variables, up);
+    for (const auto& variable : variables)
+    {
+        point.at(variable) -= 2 * step * point.at(direction_of(variable));
+    }
+    numeric_gradient(f, point, variables, down);
+
+    for (std::size_t i = 0; i < variables.size(); ++i)
+    {
+        up[i] = (up[i] - down[i]) / (2 * step);
+    }
+    return up;
+}
+
+template <typename F>
+double time_per_point(const std::vector<arg_map>& points, F&& f)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (const auto& point : points)
+    {
+        f(point);
+    }
+    const seconds elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / static_cast<double>(points.size());
+}
+
+void report(const char* label, std::size_t nodes, double build, double per_product,
+            double deviation)
+{
+    std::printf("%-8s %9zu nodes  build %8.3f s  %10.2f us/product  max deviation %g\n",
+                label, nodes, build, per_product * 1e6, deviation);
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 64;
+    const std::size_t count = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 200;
+    if (n < 2 || count == 0)
+    {
+        std::fprintf(stderr, "usage: drakmoor-bench [variables >= 2] [points > 0]\n");
+        return 2;
+    }
+
+    std::vector<std::string> variables;
+    std::vector<expression> direction;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        variables.push_back("x" + std::to_string(i));
+        direction.emplace_back(direction_of(variables.back()));
+    }
+    const auto f = rosenbrock(variables);
+
+    std::mt19937 gen{42};
+    std::uniform_real_distribution<base_type> coordinate{-2.0, 2.0};
+    std::uniform_real_distribution<base_type> component{-1.0, 1.0};
+    std::vector<arg_map> points(count);
+    for (auto& point : points)
+    {
+        for (const auto& variable : variables)
+        {
+            point[variable] = coordinate(gen);
+            point[direction_of(variable)] = component(gen);
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    dag_evaluator product{hessian_vector_product(f, variables, direction)};
+    const seconds product_build = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    std::vector<expression> entries;
+    for (const auto& first : gradient(f, variables))
+    {
+        for (auto& entry : gradient(first, variables))
+        {
+            entries.push_back(std::move(entry));
+        }
+    }
+    dag_evaluator hessian{entries};
+    const seconds hessian_build = std::chrono::steady_clock::now() - start;
+
+    dag_evaluator function{{f}};
+
+    std::vector<std::vector<base_type>> expected;
+    const auto symbolic_time = time_per_point(points, [&](const arg_map& point) {
+        expected.push_back(product.eval_at(point));
+    });
+    double scale = 0;
+    for (const auto& hv : expected)
+    {
+        for (const auto entry : hv)
+        {
+            scale = std::max(scale, std::abs(entry));
+        }
+    }
+
+    double hessian_deviation = 0;
+    std::size_t k = 0;
+    const auto hessian_time = time_per_point(points, [&](const arg_map& point) {
+        const auto& h = hessian.eval_at(point);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            base_type hv = 0;
+            for (std::size_t j = 0; j < n; ++j)
+            {
+                hv += h[i * n + j] * point.at(direction_of(variables[j]));
+            }
+            hessian_deviation = std::max(hessian_deviation, std::abs(hv - expected[k][i]));
+        }
+        ++k;
+    });
+
+    double numeric_deviation = 0;
+    k = 0;
+    const auto numeric_time = time_per_point(points, [&](const arg_map& point) {
+        const auto hv = numeric_product(function, point, variables);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            numeric_deviation = std::max(numeric_deviation, std::abs(hv[i] - expected[k][i]));
+        }
+        ++k;
+    });
+
+    std::printf("%zu variables, %zu points\n", n, count);
+    report("hvp", product.size(), product_build.count(), symbolic_time, 0);
+    report("hessian", hessian.size(), hessian_build.count(), hessian_time, hessian_deviation);
+    report("numeric", function.size(), 0, numeric_time, numeric_deviation);
+
+    // Differences of differences lose about half the digits
+    if (hessian_deviation > 1e-12 * scale || numeric_deviation > 1e-4 * scale)
+    {
+        std::fprintf(stderr, "the Hessian-vector products disagree\n");
+        return 1;
+    }
+}
@@ -0,0 +1,386 @@
+#include "derivative.hpp"
+
+namespace drakmoor
+{
+
+namespace
+{
+const constant* as_constant(const atom_ptr& a)
+{
+    return dynamic_cast<const constant*>(a.get());
+}
+
+bool is_constant(const atom_ptr& a, base_type value)
+{
+    const auto* c = as_constant(a);
+    return c != nullptr && std::isgreaterequal(c->value(), value) &&
+           std::islessequal(c->value(), value);
+}
+
+bool is_comparison(std::string_view label)
+{
+    return label == "<" || label == "<=" || label == ">" || label == ">=";
+}
+
+std::vector<const atom*> addresses(const std::vector<atom_ptr>& nodes)
+{
+    std::vector<const atom*> result;
+    result.reserve(nodes.size());
+    for (const auto& node : nodes)
+    {
+        result.push_back(node.get());
+    }
+    return result;
+}
+} // namespace
+
+expression derive(const expression& e, const std::string& variable)
+{
+    node_builder builder;
+    differentiator d{variable, builder};
+    return expression{d.derivative_of(builder.intern(e.v))};
+}
+
+std::vector<expression> gradient(const expression& e,
+                                 const std::vector<std::string>& variables)
+{
+    node_builder builder;
+    const auto f = builder.intern(e.v);
+
+    std::vector<expression> result;
+    result.reserve(variables.size());
+    for (const auto& variable : variables)
+    {
+        differentiator d{variable, builder};
+        result.emplace_back(d.derivative_of(f));
+    }
+    return result;
+}
+
+std::vector<expression> hessian_vector_product(const expression& e,
+                                               const std::vector<std::string>& variables,
+                                               const std::vector<expression>& direction)
+{
+    if (direction.size() != variables.size())
+    {
+        throw std::invalid_argument{"direction and variables differ in size"};
+    }
+
+    node_builder builder;
+    const auto f = builder.intern(e.v);
+
+    auto directional = builder.constant_node(0.0);
+    for (std::size_t j = 0; j < variables.size(); ++j)
+    {
+        differentiator d{variables[j], builder};
+        directional = builder.sum(std::move(directional),
+                                  builder.product(builder.intern(direction[j].v),
+                                                  d.derivative_of(f)));
+    }
+
+    std::vector<expression> result;
+    result.reserve(variables.size());
+    for (const auto& variable : variables)
+    {
+        differentiator d{variable, builder};
+        result.emplace_back(d.derivative_of(directional));
+    }
+    return result;
+}
+
+atom_ptr node_builder::intern(const atom_ptr& a)
+{
+    const auto found = interned.find(a.get());
+    if (found != interned.end())
+    {
+        return found->second.second;
+    }
+    a->accept(*this);
+    interned.emplace(a.get(), std::make_pair(a, shared));
+    return shared;
+}
+
+atom_ptr node_builder::constant_node(base_type value)
+{
+    if (std::isnan(value) || (std::signbit(value) && !std::islessgreater(value, 0.0)))
+    {
+        return std::make_shared<constant>(value);
+    }
+    auto& node = constants[value];
+    if (!node)
+    {
+        node = std::make_shared<constant>(value);
+    }
+    return node;
+}
+
+atom_ptr node_builder::compound_node(const operation_t& operation,
+                                     std::vector<atom_ptr> operands)
+{
+    auto& node = nodes[{node_kind::compound, std::string{std::get<1>(operation)},
+                        addresses(operands)}];
+    if (!node)
+    {
+        node = std::make_shared<compound>(operation, std::move(operands));
+    }
+    return node;
+}
+
+atom_ptr node_builder::conditional_node(atom_ptr condition, atom_ptr if_true,
+                                        atom_ptr if_false)
+{
+    // Whatever the condition, both branches give the same node
+    if (if_true == if_false)
+    {
+        return if_true;
+    }
+    auto& node = nodes[{node_kind::conditional, std::string{},
+                        {condition.get(), if_true.get(), if_false.get()}}];
+    if (!node)
+    {
+        node = std::make_shared<conditional>(std::move(condition), std::move(if_true),
+                                             std::move(if_false));
+    }
+    return node;
+}
+
+atom_ptr node_builder::piecewise_node(std::vector<piece_t> pieces, atom_ptr otherwise)
+{
+    std::vector<const atom*> operands;
+    operands.reserve(2 * pieces.size() + 1);
+    for (const auto& piece : pieces)
+    {
+        operands.push_back(piece.first.get());
+        operands.push_back(piece.second.get());
+    }
+    operands.push_back(otherwise.get());
+
+    auto& node = nodes[{node_kind::piecewise, std::string{}, std::move(operands)}];
+    if (!node)
+    {
+        node = std::make_shared<piecewise>(std::move(pieces), std::move(otherwise));
+    }
+    return node;
+}
+
+// Arithmetic that folds constants and drops neutral elements.
+
+atom_ptr node_builder::sum(atom_ptr a, atom_ptr b)
+{
+    if (is_constant(a, 0.0))
+    {
+        return b;
+    }
+    if (is_constant(b, 0.0))
+    {
+        return a;
+    }
+    if (as_constant(a) && as_constant(b))
+    {
+        return constant_node(as_constant(a)->value() + as_constant(b)->value());
+    }
+    return compound_node(addition, {std::move(a), std::move(b)});
+}
+
+atom_ptr node_builder::difference(atom_ptr a, atom_ptr b)
+{
+    if (is_constant(b, 0.0))
+    {
+        return a;
+    }
+    if (as_constant(a) && as_constant(b))
+    {
+        return constant_node(as_constant(a)->value() - as_constant(b)->value());
+    }
+    return compound_node(subtraction, {std::move(a), std::move(b)});
+}
+
+atom_ptr node_builder::product(atom_ptr a, atom_ptr b)
+{
+    if (is_constant(a, 0.0) || is_constant(b, 0.0))
+    {
+        return constant_node(0.0);
+    }
+    if (is_constant(a, 1.0))
+    {
+        return b;
+    }
+    if (is_constant(b, 1.0))
+    {
+        return a;
+    }
+    if (as_constant(a) && as_constant(b))
+    {
+        return constant_node(as_constant(a)->value() * as_constant(b)->value());
+    }
+    return compound_node(multiplication, {std::move(a), std::move(b)});
+}
+
+atom_ptr node_builder::quotient(atom_ptr a, atom_ptr b)
+{
+    if (is_constant(a, 0.0))
+    {
+        return constant_node(0.0);
+    }
+    if (is_constant(b, 1.0))
+    {
+        return a;
+    }
+    if (as_constant(a) && as_constant(b))
+    {
+        return constant_node(as_constant(a)->value() / as_constant(b)->value());
+    }
+    return compound_node(division, {std::move(a), std::move(b)});
+}
+
+void node_builder::visit(const constant& c)
+{
+    shared = constant_node(c.value());
+}
+
+void node_builder::visit(const placeholder& p)
+{
+    auto& node = placeholders[p.label()];
+    if (!node)
+    {
+        node = std::make_shared<placeholder>(p.label());
+    }
+    shared = node;
+}
+
+void node_builder::visit(const compound& c)
+{
+    std::vector<atom_ptr> operands;
+    operands.reserve(c.get_atoms().size());
+    for (const auto& v : c.get_atoms())
+    {
+        operands.push_back(intern(v));
+    }
+    shared = compound_node(c.get_operation(), std::move(operands));
+}
+
+void node_builder::visit(const conditional& c)
+{
+    auto condition = intern(c.get_condition());
+    auto if_true = intern(c.get_if_true());
+    auto if_false = intern(c.get_if_false());
+    shared = conditional_node(std::move(condition), std::move(if_true), std::move(if_false));
+}
+
+void node_builder::visit(const piecewise& p)
+{
+    std::vector<piece_t> pieces;
+    pieces.reserve(p.get_pieces().size());
+    for (const auto& piece : p.get_pieces())
+    {
+        auto condition = intern(piece.first);
+        pieces.emplace_back(std::move(condition), intern(piece.second));
+    }
+    auto otherwise = intern(p.get_otherwise());
+    shared = piecewise_node(std::move(pieces), std::move(otherwise));
+}
+
+differentiator::differentiator(std::string variable_init, node_builder& builder_init)
+    : variable{std::move(variable_init)}, builder{builder_init}
+{
+}
+
+atom_ptr differentiator::derivative_of(const atom_ptr& a)
+{
+    const auto found = derivatives.find(a.get());
+    if (found != derivatives.end())
+    {
+        return found->second;
+    }
+    a->accept(*this);
+    derivatives.emplace(a.get(), derivative);
+    return derivative;
+}
+
+void differentiator::visit(const constant&)
+{
+    derivative = builder.constant_node(0.0);
+}
+
+void differentiator::visit(const placeholder& p)
+{
+    derivative = builder.constant_node(p.label() == variable ? 1.0 : 0.0);
+}
+
+void differentiator::visit(const compound& c)
+{
+    const auto label = c.get_operation_label();
+    const auto& atoms = c.get_atoms();
+    if (atoms.empty())
+    {
+        throw std::logic_error{"no values in compound"};
+    }
+
+    // Comparisons are piecewise constant.
+    if (is_comparison(label))
+    {
+        derivative = builder.constant_node(0.0);
+        return;
+    }
+
+    // Compounds fold their values left to right, so carry (u, u') along the
+    // fold and combine it with each (v, v').
+    auto u = atoms.front();
+    auto du = derivative_of(atoms.front());
+    for (auto it = atoms.begin() + 1; it != atoms.end(); ++it)
+    {
+        const auto& v = *it;
+        auto dv = derivative_of(v);
+
+        if (label == "+")
+        {
+            du = builder.sum(std::move(du), std::move(dv));
+            u = builder.sum(std::move(u), v);
+        }
+        else if (label == "-")
+        {
+            du = builder.difference(std::move(du), std::move(dv));
+            u = builder.difference(std::move(u), v);
+        }
+        else if (label == "*")
+        {
+            du = builder.sum(builder.product(std::move(du), v), builder.product(u, std::move(dv)));
+            u = builder.product(std::move(u), v);
+        }
+        else if (label == "/")
+        {
+            du = builder.quotient(builder.difference(builder.product(std::move(du), v),
+                                                     builder.product(u, std::move(dv))),
+                                  builder.product(v, v));
+            u = builder.quotient(std::move(u), v);
+        }
+        else
+        {
+            throw std::logic_error{"cannot differentiate operation " + std::string{label}};
+        }
+    }
+    derivative = std::move(du);
+}
+
+void differentiator::visit(const conditional& c)
+{
+    auto if_true = derivative_of(c.get_if_true());
+    auto if_false = derivative_of(c.get_if_false());
+    derivative = builder.conditional_node(c.get_condition(), std::move(if_true),
+                                          std::move(if_false));
+}
+
+void differentiator::visit(const piecewise& p)
+{
+    std::vector<piece_t> pieces;
+    pieces.reserve(p.get_pieces().size());
+    for (const auto& piece : p.get_pieces())
+    {
+        auto value = derivative_of(piece.second);
+        pieces.emplace_back(piece.first, std::move(value));
+    }
+    auto otherwise = derivative_of(p.get_otherwise());
+    derivative = builder.piecewise_node(std::move(pieces), std::move(otherwise));
+}
+
+} // namespace drakmoor
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "function_expression.hpp"
+
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace drakmoor
+{
+
+// Symbolic derivative of `e` with respect to the placeholder `variable`.
+// The result is an ordinary expression that can be evaluated, printed or
+// differentiated again. Constants are folded and the trivial identities
+// (x + 0, x * 1, x * 0, ...) are applied while the result is built, and
+// structurally equal subexpressions are built once and shared. A subexpression
+// shared in `e` is differentiated once, so repeated differentiation grows a DAG
+// rather than an exponentially large tree; dag_evaluator evaluates it without
+// expanding the sharing.
+expression derive(const expression& e, const std::string& variable);
+
+// The derivatives of `e` with respect to each of `variables`, sharing their
+// common subexpressions.
+std::vector<expression> gradient(const expression& e,
+                                 const std::vector<std::string>& variables);
+
+// The Hessian of `e` over `variables` applied to `direction`, one expression
+// per variable. It is the gradient of the directional derivative
+// sum(direction[j] * de/dvariables[j]), so it costs two differentiations per
+// variable where the full Hessian costs one per pair. Placeholders for the
+// direction give one product that works for every direction.
+std::vector<expression> hessian_vector_product(const expression& e,
+                                               const std::vector<std::string>& variables,
+                                               const std::vector<expression>& direction);
+
+// Builds nodes so that structurally equal expressions are one shared node
+// (hash-consing), folding constants and neutral elements on the way.
+// Operations are told apart by their labels. Nodes stay alive as long as the
+// builder does, so node addresses identify structures.
+class node_builder : private expression_visitor
+{
+public:
+    // The shared node equal to `a`
+    atom_ptr intern(const atom_ptr& a);
+
+    atom_ptr constant_node(base_type value);
+    atom_ptr compound_node(const operation_t& operation, std::vector<atom_ptr> operands);
+    atom_ptr conditional_node(atom_ptr condition, atom_ptr if_true, atom_ptr if_false);
+    atom_ptr piecewise_node(std::vector<piece_t> pieces, atom_ptr otherwise);
+
+    atom_ptr sum(atom_ptr a, atom_ptr b);
+    atom_ptr difference(atom_ptr a, atom_ptr b);
+    atom_ptr product(atom_ptr a, atom_ptr b);
+    atom_ptr quotient(atom_ptr a, atom_ptr b);
+
+private:
+    void visit(const constant&) override;
+    void visit(const placeholder&) override;
+    void visit(const compound&) override;
+    void visit(const conditional&) override;
+    void visit(const piecewise&) override;
+
+    enum class node_kind
+    {
+        compound,
+        conditional,
+        piecewise
+    };
+
+    // Operands are shared nodes, so their addresses stand for their structure
+    using node_key = std::tuple<node_kind, std::string, std::vector<const atom*>>;
+
+    std::map<base_type, atom_ptr> constants; // NaN and -0 are never shared
+    std::map<std::string, atom_ptr> placeholders;
+    std::map<node_key, atom_ptr> nodes;
+    // Each interned node, kept alive so that its address is not reused, and
+    // its shared equal
+    std::map<const atom*, std::pair<atom_ptr, atom_ptr>> interned;
+    atom_ptr shared; // the result of visiting a node
+};
+
+class differentiator : public expression_visitor
+{
+public:
+    differentiator(std::string variable_init, node_builder& builder_init);
+
+    void visit(const constant&) override;
+    void visit(const placeholder&) override;
+    void visit(const compound&) override;
+    void visit(const conditional&) override;
+    void visit(const piecewise&) override;
+
+    // `a` must have been built or interned by the builder
+    atom_ptr derivative_of(const atom_ptr& a);
+
+private:
+    std::string variable;
+    node_builder& builder;
+    std::map<const atom*, atom_ptr> derivatives;
+    atom_ptr derivative;
+};
+
+}
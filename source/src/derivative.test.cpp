@@ -0,0 +1,166 @@
+#include <catch.hpp>
+#include "derivative.hpp"
+#include <sstream>
+
+namespace
+{
+std::string print(const drakmoor::expression& e)
+{
+    std::stringstream ss;
+    drakmoor::printer p(ss);
+    e.accept(p);
+    return ss.str();
+}
+}
+
+TEST_CASE("derivative of constants and placeholders", "[derivative]")
+{
+    using namespace drakmoor;
+
+    REQUIRE(print(derive(expression{3.0}, "x")) == "0");
+    REQUIRE(print(derive(expression{"x"}, "x")) == "1");
+    REQUIRE(print(derive(expression{"y"}, "x")) == "0");
+}
+
+TEST_CASE("derivative folds constants", "[derivative]")
+{
+    using namespace drakmoor;
+
+    REQUIRE(print(derive(expression{"x"} * expression{"x"}, "x")) == "(x + x)");
+    REQUIRE(print(derive(expression{3.0} * expression{"x"} + expression{"y"}, "x")) == "3");
+    REQUIRE(print(derive(expression{"x"} - expression{"y"}, "y")) == "-1");
+}
+
+TEST_CASE("derivative of a quotient", "[derivative]")
+{
+    using namespace drakmoor;
+    auto expr = expression{"x"} / (expression{"x"} + expression{1.0});
+    auto d = derive(expr, "x");
+
+    // d/dx x / (x + 1) = 1 / (x + 1)^2
+    REQUIRE(d.eval_at({{"x", 1.0}}) == Approx(0.25));
+    REQUIRE(d.eval_at({{"x", 3.0}}) == Approx(1.0 / 16.0));
+}
+
+TEST_CASE("second derivative", "[derivative]")
+{
+    using namespace drakmoor;
+    auto expr = expression{"x"} * expression{"x"} * expression{"y"};
+    auto dxx = derive(derive(expr, "x"), "x");
+    auto dxy = derive(derive(expr, "x"), "y");
+
+    arg_map am = {{"x", 3.0}, {"y", 5.0}};
+    REQUIRE(dxx.eval_at(am) == Approx(10.0));
+    REQUIRE(dxy.eval_at(am) == Approx(6.0));
+}
+
+TEST_CASE("derivative of conditionals", "[derivative]")
+{
+    using namespace drakmoor;
+    auto expr = select(expression{"x"} > expression{0.0}, expression{"x"} * expression{"x"},
+                       expression{2.0} * expression{"x"});
+    auto d = derive(expr, "x");
+
+    REQUIRE(print(d) == "if((x > 0), (x + x), 2)");
+    REQUIRE(d.eval_at({{"x", 3.0}}) == Approx(6.0));
+    REQUIRE(d.eval_at({{"x", -3.0}}) == Approx(2.0));
+}
+
+TEST_CASE("repeated derivatives of a nested product stay small", "[derivative]")
+{
+    using namespace drakmoor;
+
+    // x * (x * (... * (x * y))) = x^k y, whose n-th derivative expands into a
+    // tree of tens of thousands of nodes for k = 8 already
+    constexpr int k = 12;
+    expression f{"y"};
+    for (int i = 0; i < k; ++i)
+    {
+        f = expression{"x"} * f;
+    }
+
+    auto d = f;
+    base_type falling_factorial = 1.0;
+    for (int n = 1; n <= k; ++n)
+    {
+        d = derive(d, "x");
+        falling_factorial *= k - n + 1;
+
+        REQUIRE(node_count(d) <= 2 * k * k);
+        dag_evaluator evaluator{{d}};
+        REQUIRE(evaluator.eval_at({{"x", 1.0}, {"y", 1.0}})[0] == Approx(falling_factorial));
+    }
+}
+
+TEST_CASE("shared subexpressions are differentiated once", "[derivative]")
+{
+    using namespace drakmoor;
+
+    // (x + 1)^(2^30) as 30 nested squares; as a tree it has 2^31 leaves
+    auto p = expression{"x"} + expression{1.0};
+    for (int i = 0; i < 30; ++i)
+    {
+        p = p * p;
+    }
+    auto d = derive(p, "x");
+
+    REQUIRE(node_count(p) == 33);
+    REQUIRE(node_count(d) <= 4 * 33);
+    dag_evaluator evaluator{{d}};
+    REQUIRE(evaluator.eval_at({{"x", 0.0}})[0] == Approx(1u << 30));
+}
+
+TEST_CASE("equal subexpressions are built once", "[derivative]")
+{
+    using namespace drakmoor;
+    auto x = [] { return expression{"x"}; };
+    auto y = [] { return expression{"y"}; };
+
+    // d/dx of (x*y)*(x*y) written out twice: both factors are the same node
+    auto d = derive((x() * y()) * (x() * y()), "x");
+    REQUIRE(print(d) == "((y * (x * y)) + ((x * y) * y))");
+    REQUIRE(node_count(d) == 6);
+}
+
+TEST_CASE("gradient and Hessian-vector product", "[derivative]")
+{
+    using namespace drakmoor;
+    const expression x{"x"};
+    const expression y{"y"};
+    const expression z{"z"};
+    const std::vector<std::string> variables{"x", "y", "z"};
+
+    // f = x^2 y + y^2 z + x z
+    const auto f = x * x * y + y * y * z + x * z;
+    const arg_map point = {{"x", 1.0}, {"y", 2.0}, {"z", 3.0},
+                           {"vx", 1.0}, {"vy", -1.0}, {"vz", 2.0}};
+
+    dag_evaluator grad{gradient(f, variables)};
+    const auto& g = grad.eval_at(point);
+    REQUIRE(g[0] == Approx(7.0));
+    REQUIRE(g[1] == Approx(13.0));
+    REQUIRE(g[2] == Approx(5.0));
+
+    // H = [[2y, 2x, 1], [2x, 2z, 2y], [1, 2y, 0]] applied to (vx, vy, vz)
+    const auto hvp = hessian_vector_product(
+        f, variables, {expression{"vx"}, expression{"vy"}, expression{"vz"}});
+    dag_evaluator product{hvp};
+    const auto& h = product.eval_at(point);
+    REQUIRE(h[0] == Approx(4.0));
+    REQUIRE(h[1] == Approx(4.0));
+    REQUIRE(h[2] == Approx(-3.0));
+
+    // The same as the full Hessian times the direction
+    for (std::size_t i = 0; i < variables.size(); ++i)
+    {
+        base_type expected = 0.0;
+        for (std::size_t j = 0; j < variables.size(); ++j)
+        {
+            expected += derive(derive(f, variables[i]), variables[j]).eval_at(point) *
+                        point.at("v" + variables[j]);
+        }
+        REQUIRE(h[i] == Approx(expected));
+    }
+
+    REQUIRE_THROWS_AS(hessian_vector_product(f, variables, {x}), std::invalid_argument);
+}
@@ -1,9 +1,185 @@
 #include "function_expression.hpp"
+#include <numeric>
 #include <ostream>
 
 namespace drakmoor
 {
 
+namespace
+{
+using lane_list = std::vector<std::size_t>;
+
+// Copies the given lanes of every column of a batch of all_lanes points into a
+// smaller batch.
+batch_arg_map gather(const batch_arg_map& points, const lane_list& lanes,
+                     std::size_t all_lanes)
+{
+    batch_arg_map selected;
+    for (const auto& [id, column] : points)
+    {
+        if (column.size() != all_lanes)
+        {
+            throw std::invalid_argument{"batch column size mismatch for " + id};
+        }
+        auto& selected_column = selected[id];
+        selected_column.reserve(lanes.size());
+        for (const auto lane : lanes)
+        {
+            selected_column.push_back(column[lane]);
+        }
+    }
+    return selected;
+}
+
+void scatter(const batch_values& values, const lane_list& lanes, batch_values& out)
+{
+    for (std::size_t i = 0; i < lanes.size(); ++i)
+    {
+        out[lanes[i]] = values[i];
+    }
+}
+
+// Evaluates `value` only on the listed lanes of `points` and writes the results
+// to the matching lanes of `out`.
+void eval_on_lanes(const atom& value, const batch_arg_map& points, const lane_list& lanes,
+                   std::size_t all_lanes, branch_mode mode, batch_values& out)
+{
+    if (lanes.empty())
+    {
+        return;
+    }
+    if (lanes.size() == all_lanes)
+    {
+        out = value.eval_batch(points, all_lanes, mode);
+        return;
+    }
+    scatter(value.eval_batch(gather(points, lanes, all_lanes), lanes.size(), mode), lanes,
+            out);
+}
+} // namespace
+
+batch_values compound::eval_batch(const batch_arg_map& points, std::size_t lanes,
+                                  branch_mode mode) const
+{
+    if (values.empty())
+    {
+        throw std::logic_error{"no values in compound"};
+    }
+
+    auto result = values.front()->eval_batch(points, lanes, mode);
+    const auto& op = std::get<0>(operation);
+    std::for_each(values.begin() + 1, values.end(), [&](const auto& v) {
+        const auto rhs = v->eval_batch(points, lanes, mode);
+        for (std::size_t i = 0; i < lanes; ++i)
+        {
+            result[i] = op(result[i], rhs[i]);
+        }
+    });
+    return result;
+}
+
+batch_values conditional::eval_batch(const batch_arg_map& points, std::size_t lanes,
+                                     branch_mode mode) const
+{
+    const auto c = condition->eval_batch(points, lanes, mode);
+
+    if (mode == branch_mode::blend)
+    {
+        const auto t = if_true->eval_batch(points, lanes, mode);
+        const auto f = if_false->eval_batch(points, lanes, mode);
+        batch_values result(lanes);
+        for (std::size_t i = 0; i < lanes; ++i)
+        {
+            result[i] = is_true(c[i]) ? t[i] : f[i];
+        }
+        return result;
+    }
+
+    lane_list taken;
+    lane_list not_taken;
+    for (std::size_t i = 0; i < lanes; ++i)
+    {
+        (is_true(c[i]) ? taken : not_taken).push_back(i);
+    }
+
+    batch_values result(lanes);
+    eval_on_lanes(*if_true, points, taken, lanes, mode, result);
+    eval_on_lanes(*if_false, points, not_taken, lanes, mode, result);
+    return result;
+}
+
+batch_values piecewise::eval_batch(const batch_arg_map& points, std::size_t lanes,
+                                   branch_mode mode) const
+{
+    if (mode == branch_mode::blend)
+    {
+        auto result = otherwise->eval_batch(points, lanes, mode);
+        std::for_each(pieces.rbegin(), pieces.rend(), [&](const auto& piece) {
+            const auto c = piece.first->eval_batch(points, lanes, mode);
+            const auto v = piece.second->eval_batch(points, lanes, mode);
+            for (std::size_t i = 0; i < lanes; ++i)
+            {
+                result[i] = is_true(c[i]) ? v[i] : result[i];
+            }
+        });
+        return result;
+    }
+
+    // Lanes not yet claimed by a piece, as indices into the original batch, and
+    // the sub-batch holding just those lanes.
+    lane_list remaining(lanes);
+    std::iota(remaining.begin(), remaining.end(), std::size_t{0});
+    const batch_arg_map* remaining_points = &points;
+    batch_arg_map narrowed_points;
+
+    batch_values result(lanes);
+    for (const auto& piece : pieces)
+    {
+        if (remaining.empty())
+        {
+            return result;
+        }
+
+        const auto c = piece.first->eval_batch(*remaining_points, remaining.size(), mode);
+        lane_list taken;
+        lane_list rest;
+        for (std::size_t i = 0; i < remaining.size(); ++i)
+        {
+            (is_true(c[i]) ? taken : rest).push_back(i);
+        }
+
+        if (taken.empty())
+        {
+            continue;
+        }
+
+        batch_values picked(remaining.size());
+        eval_on_lanes(*piece.second, *remaining_points, taken, remaining.size(), mode,
+                      picked);
+        for (const auto lane : taken)
+        {
+            result[remaining[lane]] = picked[lane];
+        }
+
+        narrowed_points = gather(*remaining_points, rest, remaining.size());
+        remaining_points = &narrowed_points;
+        lane_list next_remaining;
+        next_remaining.reserve(rest.size());
+        for (const auto lane : rest)
+        {
+            next_remaining.push_back(remaining[lane]);
+        }
+        remaining = std::move(next_remaining);
+    }
+
+    if (!remaining.empty())
+    {
+        const auto v = otherwise->eval_batch(*remaining_points, remaining.size(), mode);
+        scatter(v, remaining, result);
+    }
+    return result;
+}
+
 void constant::accept(expression_visitor& ev) const
 {
     ev.visit(*this);
@@ -19,6 +195,16 @@ void compound::accept(expression_visitor& ev) const
     ev.visit(*this);
 }
 
+void conditional::accept(expression_visitor& ev) const
+{
+    ev.visit(*this);
+}
+
+void piecewise::accept(expression_visitor& ev) const
+{
+    ev.visit(*this);
+}
+
 printer::printer(std::ostream& p_os) : os(p_os)
 {
 }
@@ -46,4 +232,176 @@ void printer::visit(const compound& b)
     }
 }
 
+void printer::visit(const conditional& c)
+{
+    os << "if(";
+    c.get_condition()->accept(*this);
+    os << ", ";
+    c.get_if_true()->accept(*this);
+    os << ", ";
+    c.get_if_false()->accept(*this);
+    os << ')';
+}
+
+void printer::visit(const piecewise& p)
+{
+    os << "piecewise(";
+    for (const auto& piece : p.get_pieces())
+    {
+        piece.first->accept(*this);
+        os << ": ";
+        piece.second->accept(*this);
+        os << ", ";
+    }
+    p.get_otherwise()->accept(*this);
+    os << ')';
+}
+
+namespace
+{
+// Orders the distinct nodes below some roots so that operands come first
+class flattener : public expression_visitor
+{
+public:
+    std::size_t add(const atom& a)
+    {
+        const auto found = index.find(&a);
+        if (found != index.end())
+        {
+            return found->second;
+        }
+        a.accept(*this);
+        index.emplace(&a, steps.size());
+        steps.push_back(std::move(current));
+        return steps.size() - 1;
+    }
+
+    void visit(const constant& c) override
+    {
+        current = {dag_evaluator::step_kind::constant, &c, {}};
+    }
+
+    void visit(const placeholder& p) override
+    {
+        current = {dag_evaluator::step_kind::placeholder, &p, {}};
+    }
+
+    void visit(const compound& c) override
+    {
+        std::vector<std::size_t> operands;
+        for (const auto& v : c.get_atoms())
+        {
+            operands.push_back(add(*v));
+        }
+        current = {dag_evaluator::step_kind::compound, &c, std::move(operands)};
+    }
+
+    void visit(const conditional& c) override
+    {
+        std::vector<std::size_t> operands{add(*c.get_condition()), add(*c.get_if_true()),
+                                          add(*c.get_if_false())};
+        current = {dag_evaluator::step_kind::conditional, &c, std::move(operands)};
+    }
+
+    void visit(const piecewise& p) override
+    {
+        std::vector<std::size_t> operands;
+        for (const auto& piece : p.get_pieces())
+        {
+            operands.push_back(add(*piece.first));
+            operands.push_back(add(*piece.second));
+        }
+        operands.push_back(add(*p.get_otherwise()));
+        current = {dag_evaluator::step_kind::piecewise, &p, std::move(operands)};
+    }
+
+    std::vector<dag_evaluator::step> steps;
+
+private:
+    std::map<const atom*, std::size_t> index;
+    dag_evaluator::step current{};
+};
+} // namespace
+
+std::size_t node_count(const expression& e)
+{
+    flattener f;
+    f.add(*e.v);
+    return f.steps.size();
+}
+
+dag_evaluator::dag_evaluator(const std::vector<expression>& outputs)
+{
+    flattener f;
+    for (const auto& output : outputs)
+    {
+        roots.push_back(output.v);
+        output_steps.push_back(f.add(*output.v));
+    }
+    steps = std::move(f.steps);
+    values.resize(steps.size());
+    results.resize(output_steps.size());
+
+    for (std::size_t i = 0; i < steps.size(); ++i)
+    {
+        if (steps[i].kind == step_kind::constant)
+        {
+            values[i] = static_cast<const constant*>(steps[i].node)->value();
+        }
+    }
+}
+
+const std::vector<base_type>& dag_evaluator::eval_at(const arg_map& point)
+{
+    for (std::size_t i = 0; i < steps.size(); ++i)
+    {
+        const auto& operands = steps[i].operands;
+        switch (steps[i].kind)
+        {
+        case step_kind::constant:
+            // set by the constructor
+            break;
+        case step_kind::placeholder:
+            values[i] = point.at(static_cast<const placeholder*>(steps[i].node)->label());
+            break;
+        case step_kind::compound:
+        {
+            const auto& operation =
+                std::get<0>(static_cast<const compound*>(steps[i].node)->get_operation());
+            base_type result = values[operands.front()];
+            for (auto o = operands.begin() + 1; o != operands.end(); ++o)
+            {
+                result = operation(result, values[*o]);
+            }
+            values[i] = result;
+            break;
+        }
+        case step_kind::conditional:
+            values[i] = is_true(values[operands[0]]) ? values[operands[1]]
+                                                     : values[operands[2]];
+            break;
+        case step_kind::piecewise:
+        {
+            std::size_t picked = operands.back();
+            for (std::size_t k = 0; k + 1 < operands.size(); k += 2)
+            {
+                if (is_true(values[operands[k]]))
+                {
+                    picked = operands[k + 1];
+                    break;
+                }
+            }
+            values[i] = values[picked];
+            break;
+        }
+        }
+    }
+
+    for (std::size_t k = 0; k < output_steps.size(); ++k)
+    {
+        results[k] = values[output_steps[k]];
+    }
+    return results;
+}
+
 } // namespace drakmoor
@@ -1,12 +1,16 @@
 #pragma once
 
 #include <algorithm>
+#include <cmath>
+#include <cstddef>
 #include <functional>
 #include <iosfwd>
 #include <map>
 #include <memory>
 #include <numeric>
+#include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace drakmoor
@@ -15,14 +19,43 @@ namespace drakmoor
 using base_type = double;
 using arg_map = std::map<std::string, base_type>;
 
+// A batch of points: one column of values per placeholder, one lane per point.
+using batch_arg_map = std::map<std::string, std::vector<base_type>>;
+using batch_values = std::vector<base_type>;
+
+// How conditional nodes spend work on a batch.
+//   blend     - evaluate every branch on every lane and pick per lane; the
+//               select loop is branch-free and vectorizes.
+//   partition - split the lanes by predicate and evaluate each branch only on
+//               the lanes that take it; pays off when branches are expensive.
+enum class branch_mode
+{
+    blend,
+    partition
+};
+
+// Conditions are numbers; anything other than zero (or NaN) selects the branch.
+inline bool is_true(base_type condition)
+{
+    return std::islessgreater(condition, base_type{0});
+}
+
 class expression;
 class expression_visitor;
 
+// Nodes are immutable once built, so several parents may share one and an
+// expression is a DAG rather than a tree. clone() copies the node itself and
+// shares its operands.
+class atom;
+using atom_ptr = std::shared_ptr<const atom>;
+
 class atom
 {
 public:
     virtual ~atom() = default;
     virtual base_type eval_at(const arg_map&) const = 0;
+    virtual batch_values eval_batch(const batch_arg_map&, std::size_t lanes,
+                                    branch_mode) const = 0;
     virtual std::unique_ptr<atom> clone() const = 0;
     virtual void accept(expression_visitor&) const = 0;
 };
@@ -39,6 +72,12 @@ public:
         return v;
     }
 
+    batch_values eval_batch(const batch_arg_map&, std::size_t lanes,
+                            branch_mode) const override
+    {
+        return batch_values(lanes, v);
+    }
+
     std::unique_ptr<atom> clone() const override
     {
         return std::make_unique<constant>(*this);
@@ -64,6 +103,17 @@ public:
         return point.at(id);
     }
 
+    batch_values eval_batch(const batch_arg_map& points, std::size_t lanes,
+                            branch_mode) const override
+    {
+        const auto& column = points.at(id);
+        if (column.size() != lanes)
+        {
+            throw std::invalid_argument{"batch column size mismatch for " + id};
+        }
+        return column;
+    }
+
     std::unique_ptr<atom> clone() const override
     {
         return std::make_unique<placeholder>(*this);
@@ -79,23 +129,25 @@ private:
 
 using operation_t = std::pair<std::function<base_type(base_type, base_type)>, std::string_view>;
 
+inline const operation_t addition{std::plus<base_type>{}, "+"};
+inline const operation_t subtraction{std::minus<base_type>{}, "-"};
+inline const operation_t multiplication{std::multiplies<base_type>{}, "*"};
+inline const operation_t division{std::divides<base_type>{}, "/"};
+
 class compound : public atom
 {
 public:
-    compound(operation_t operation_init, std::unique_ptr<atom> v1,
-             std::unique_ptr<atom> v2)
+    compound(operation_t operation_init, atom_ptr v1, atom_ptr v2)
         : operation{std::move(operation_init)}
     {
-        values.emplace_back(v1->clone());
-        values.emplace_back(v2->clone());
+        values.reserve(2);
+        values.emplace_back(std::move(v1));
+        values.emplace_back(std::move(v2));
     }
 
-    compound(const compound& other) : operation{other.operation}
+    compound(operation_t operation_init, std::vector<atom_ptr> values_init)
+        : operation{std::move(operation_init)}, values{std::move(values_init)}
     {
-        values.reserve(other.values.size());
-        std::transform(other.values.begin(), other.values.end(),
-                       std::back_inserter(values),
-                       [](const auto& other_value) { return other_value->clone(); });
     }
 
     base_type eval_at(const arg_map& point) const override
@@ -105,16 +157,19 @@ public:
             throw std::logic_error{"no values in compound"};
         }
 
-        std::vector<base_type> evaluated_values;
-        evaluated_values.reserve(values.size());
-
-        std::transform(values.begin(), values.end(), std::back_inserter(evaluated_values),
-                       [&](const auto& v) { return v->eval_at(point); });
-
-        return std::accumulate(evaluated_values.begin() + 1, evaluated_values.end(),
-                               *evaluated_values.begin(), std::get<0>(operation));
+        // Folded as the values come, so that evaluation does not allocate
+        auto v = values.begin();
+        base_type result = (*v)->eval_at(point);
+        for (++v; v != values.end(); ++v)
+        {
+            result = std::get<0>(operation)(result, (*v)->eval_at(point));
+        }
+        return result;
     }
 
+    batch_values eval_batch(const batch_arg_map& points, std::size_t lanes,
+                            branch_mode mode) const override;
+
     std::unique_ptr<atom> clone() const override
     {
         return std::make_unique<compound>(*this);
@@ -127,6 +182,11 @@ public:
         return std::get<1>(operation);
     }
 
+    const operation_t& get_operation() const
+    {
+        return operation;
+    }
+
     const auto& get_atoms() const
     {
         return values;
@@ -134,22 +194,110 @@ public:
 
 private:
     operation_t operation;
-    std::vector<std::unique_ptr<atom>> values;
+    std::vector<atom_ptr> values;
+};
+
+// select(c, a, b): evaluates c and then only the branch it picks.
+class conditional : public atom
+{
+public:
+    conditional(atom_ptr condition_init, atom_ptr if_true_init, atom_ptr if_false_init)
+        : condition{std::move(condition_init)},
+          if_true{std::move(if_true_init)},
+          if_false{std::move(if_false_init)}
+    {
+    }
+
+    base_type eval_at(const arg_map& point) const override
+    {
+        return is_true(condition->eval_at(point)) ? if_true->eval_at(point)
+                                                  : if_false->eval_at(point);
+    }
+
+    batch_values eval_batch(const batch_arg_map& points, std::size_t lanes,
+                            branch_mode mode) const override;
+
+    std::unique_ptr<atom> clone() const override
+    {
+        return std::make_unique<conditional>(*this);
+    }
+
+    void accept(expression_visitor& ev) const override;
+
+    const atom_ptr& get_condition() const { return condition; }
+    const atom_ptr& get_if_true() const { return if_true; }
+    const atom_ptr& get_if_false() const { return if_false; }
+
+private:
+    atom_ptr condition;
+    atom_ptr if_true;
+    atom_ptr if_false;
+};
+
+// (condition, value) pair of a piecewise function.
+using piece_t = std::pair<atom_ptr, atom_ptr>;
+
+// Pieces are tried in order; the first true condition picks its value, and
+// `otherwise` is used when none holds. Only the picked value is evaluated.
+class piecewise : public atom
+{
+public:
+    piecewise(std::vector<piece_t> pieces_init, atom_ptr otherwise_init)
+        : pieces{std::move(pieces_init)}, otherwise{std::move(otherwise_init)}
+    {
+    }
+
+    base_type eval_at(const arg_map& point) const override
+    {
+        for (const auto& piece : pieces)
+        {
+            if (is_true(piece.first->eval_at(point)))
+            {
+                return piece.second->eval_at(point);
+            }
+        }
+        return otherwise->eval_at(point);
+    }
+
+    batch_values eval_batch(const batch_arg_map& points, std::size_t lanes,
+                            branch_mode mode) const override;
+
+    std::unique_ptr<atom> clone() const override
+    {
+        return std::make_unique<piecewise>(*this);
+    }
+
+    void accept(expression_visitor& ev) const override;
+
+    const auto& get_pieces() const
+    {
+        return pieces;
+    }
+
+    const atom_ptr& get_otherwise() const { return otherwise; }
+
+private:
+    std::vector<piece_t> pieces;
+    atom_ptr otherwise;
 };
 
 class expression
 {
 public:
-    expression(base_type c) : v{std::make_unique<constant>(c)}
+    expression(base_type c) : v{std::make_shared<constant>(c)}
     {
     }
 
-    expression(std::string id) : v{std::make_unique<placeholder>(id)}
+    expression(std::string id) : v{std::make_shared<placeholder>(id)}
     {
     }
 
     expression(operation_t op, expression e1, expression e2)
-        : v{std::make_unique<compound>(op, std::move(e1.v), std::move(e2.v))}
+        : v{std::make_shared<compound>(op, std::move(e1.v), std::move(e2.v))}
+    {
+    }
+
+    explicit expression(atom_ptr a) : v{std::move(a)}
     {
     }
 
@@ -158,32 +306,89 @@ public:
         return v->eval_at(point);
     }
 
+    batch_values eval_batch(const batch_arg_map& points, std::size_t lanes,
+                            branch_mode mode = branch_mode::blend) const
+    {
+        return v->eval_batch(points, lanes, mode);
+    }
+
     void accept(expression_visitor& ev) const
     {
         v->accept(ev);
     }
 
-    std::unique_ptr<atom> v;
+    atom_ptr v;
 };
 
 inline expression operator+(expression e1, expression e2)
 {
-    return expression({std::plus<base_type>{}, "+"}, std::move(e1), std::move(e2));
+    return expression(addition, std::move(e1), std::move(e2));
 }
 
 inline expression operator-(expression e1, expression e2)
 {
-    return expression({std::minus<base_type>{}, "-"}, std::move(e1), std::move(e2));
+    return expression(subtraction, std::move(e1), std::move(e2));
 }
 
 inline expression operator*(expression e1, expression e2)
 {
-    return expression({std::multiplies<base_type>{}, "*"}, std::move(e1), std::move(e2));
+    return expression(multiplication, std::move(e1), std::move(e2));
 }
 
 inline expression operator/(expression e1, expression e2)
 {
-    return expression({std::divides<base_type>{}, "/"}, std::move(e1), std::move(e2));
+    return expression(division, std::move(e1), std::move(e2));
+}
+
+template <typename Compare>
+operation_t make_comparison(std::string_view label)
+{
+    return {[](base_type a, base_type b) {
+                return Compare{}(a, b) ? base_type{1} : base_type{0};
+            },
+            label};
+}
+
+inline expression operator<(expression e1, expression e2)
+{
+    return expression(make_comparison<std::less<base_type>>("<"), std::move(e1),
+                      std::move(e2));
+}
+
+inline expression operator<=(expression e1, expression e2)
+{
+    return expression(make_comparison<std::less_equal<base_type>>("<="), std::move(e1),
+                      std::move(e2));
+}
+
+inline expression operator>(expression e1, expression e2)
+{
+    return expression(make_comparison<std::greater<base_type>>(">"), std::move(e1),
+                      std::move(e2));
+}
+
+inline expression operator>=(expression e1, expression e2)
+{
+    return expression(make_comparison<std::greater_equal<base_type>>(">="),
+                      std::move(e1), std::move(e2));
+}
+
+inline expression select(expression condition, expression if_true, expression if_false)
+{
+    return expression{std::make_shared<conditional>(
+        std::move(condition.v), std::move(if_true.v), std::move(if_false.v))};
+}
+
+inline expression make_piecewise(std::vector<std::pair<expression, expression>> pieces,
+                                 expression otherwise)
+{
+    std::vector<piece_t> atoms;
+    atoms.reserve(pieces.size());
+    for (auto& piece : pieces)
+    {
+        atoms.emplace_back(std::move(piece.first.v), std::move(piece.second.v));
+    }
+    return expression{std::make_shared<piecewise>(std::move(atoms), std::move(otherwise.v))};
 }
 
 class expression_visitor
@@ -194,6 +399,8 @@ public:
     virtual void visit(const constant&) = 0;
     virtual void visit(const placeholder&)  = 0;
     virtual void visit(const compound&)  = 0;
+    virtual void visit(const conditional&) = 0;
+    virtual void visit(const piecewise&) = 0;
 };
 
 class printer : public expression_visitor
@@ -204,9 +411,55 @@ public:
     void visit(const constant&) override;
     void visit(const placeholder&) override;
     void visit(const compound&) override;
+    void visit(const conditional&) override;
+    void visit(const piecewise&) override;
 
 private:
     std::ostream& os;
 };
 
+// The number of distinct nodes of `e`; a node shared by several parents counts
+// once.
+std::size_t node_count(const expression& e);
+
+// Evaluates expressions that share nodes, computing every distinct node once
+// per point where expression::eval_at follows every path to it. Conditions do
+// not guard their branches here: every node is evaluated, as with
+// branch_mode::blend, so every placeholder must be bound.
+class dag_evaluator
+{
+public:
+    explicit dag_evaluator(const std::vector<expression>& outputs);
+
+    // One value per output
+    const std::vector<base_type>& eval_at(const arg_map& point);
+
+    // Distinct nodes over all outputs
+    std::size_t size() const { return steps.size(); }
+
+    enum class step_kind
+    {
+        constant,
+        placeholder,
+        compound,
+        conditional,
+        piecewise
+    };
+
+    // A node, after the steps computing its operands
+    struct step
+    {
+        step_kind kind;
+        const atom* node;
+        std::vector<std::size_t> operands; // piecewise: conditions and values, otherwise
+    };
+
+private:
+    std::vector<atom_ptr> roots; // keeps the nodes of the steps alive
+    std::vector<step> steps;
+    std::vector<std::size_t> output_steps;
+    std::vector<base_type> values; // one per step
+    std::vector<base_type> results;
+};
+
 }
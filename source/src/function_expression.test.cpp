@@ -120,3 +120,152 @@ SECTION("simple expression with single variable - division")
 }
 
 }
+
+TEST_CASE("comparison yields one or zero", "[conditional]")
+{
+    using namespace drakmoor;
+    arg_map am = {{"x", 2.0}};
+
+    REQUIRE((expression{"x"} < expression{3.0}).eval_at(am) == Approx(1.0));
+    REQUIRE((expression{"x"} >= expression{3.0}).eval_at(am) == Approx(0.0));
+    REQUIRE((expression{"x"} <= expression{2.0}).eval_at(am) == Approx(1.0));
+    REQUIRE((expression{"x"} > expression{2.0}).eval_at(am) == Approx(0.0));
+}
+
+TEST_CASE("select evaluates only the chosen branch", "[conditional]")
+{
+    using namespace drakmoor;
+    // "y" is not bound, so evaluating the false branch would throw
+    auto expr = select(expression{"x"} > expression{0.0}, expression{"x"} * expression{2.0},
+                       expression{"y"});
+
+    REQUIRE(expr.eval_at({{"x", 4.0}}) == Approx(8.0));
+    REQUIRE_THROWS_AS(expr.eval_at({{"x", -4.0}}), std::out_of_range);
+}
+
+TEST_CASE("piecewise picks the first true piece", "[conditional]")
+{
+    using namespace drakmoor;
+    std::vector<std::pair<expression, expression>> pieces;
+    pieces.emplace_back(expression{"x"} < expression{0.0}, expression{0.0});
+    pieces.emplace_back(expression{"x"} < expression{1.0}, expression{"x"});
+    auto expr = make_piecewise(std::move(pieces), expression{1.0});
+
+    REQUIRE(expr.eval_at({{"x", -3.0}}) == Approx(0.0));
+    REQUIRE(expr.eval_at({{"x", 0.25}}) == Approx(0.25));
+    REQUIRE(expr.eval_at({{"x", 7.0}}) == Approx(1.0));
+}
+
+TEST_CASE("batch evaluation of conditionals", "[conditional]")
+{
+    using namespace drakmoor;
+    auto make_expr = [] {
+        std::vector<std::pair<expression, expression>> pieces;
+        pieces.emplace_back(expression{"x"} < expression{0.0}, expression{0.0});
+        pieces.emplace_back(expression{"x"} < expression{1.0},
+                            select(expression{"y"} > expression{0.0}, expression{"x"},
+                                   expression{"y"}));
+        return make_piecewise(std::move(pieces), expression{"x"} * expression{"y"});
+    };
+
+    const batch_arg_map points = {{"x", {-1.0, 0.5, 0.5, 3.0}}, {"y", {9.0, 2.0, -2.0, 4.0}}};
+    const batch_values expected = {0.0, 0.5, -2.0, 12.0};
+
+    SECTION("blend")
+    {
+        const auto values = make_expr().eval_batch(points, 4, branch_mode::blend);
+        REQUIRE(values.size() == expected.size());
+        for (std::size_t i = 0; i < expected.size(); ++i)
+        {
+            REQUIRE(values[i] == Approx(expected[i]));
+        }
+    }
+
+    SECTION("partition")
+    {
+        const auto values = make_expr().eval_batch(points, 4, branch_mode::partition);
+        REQUIRE(values.size() == expected.size());
+        for (std::size_t i = 0; i < expected.size(); ++i)
+        {
+            REQUIRE(values[i] == Approx(expected[i]));
+        }
+    }
+
+    SECTION("partition skips branches no lane takes")
+    {
+        auto expr = select(expression{"x"} > expression{0.0}, expression{"x"},
+                           expression{"unbound"});
+        const batch_arg_map positive = {{"x", {1.0, 2.0}}};
+
+        REQUIRE_NOTHROW(expr.eval_batch(positive, 2, branch_mode::partition));
+        REQUIRE_THROWS_AS(expr.eval_batch(positive, 2, branch_mode::blend),
+                          std::out_of_range);
+    }
+
+    SECTION("columns shorter than the batch throw in either mode")
+    {
+        auto expr = select(expression{"x"} > expression{0.0}, expression{"y"},
+                           expression{0.0});
+        const batch_arg_map short_y = {{"x", {1.0, -1.0, 1.0, 1.0}}, {"y", {2.0, 3.0}}};
+
+        REQUIRE_THROWS_AS(expr.eval_batch(short_y, 4, branch_mode::blend),
+                          std::invalid_argument);
+        REQUIRE_THROWS_AS(expr.eval_batch(short_y, 4, branch_mode::partition),
+                          std::invalid_argument);
+    }
+}
+
+TEST_CASE("printing conditionals", "[printing]")
+{
+    using namespace drakmoor;
+    std::vector<std::pair<expression, expression>> pieces;
+    pieces.emplace_back(expression{"x"} < expression{0.0}, expression{0.0});
+    auto expr = make_piecewise(std::move(pieces),
+                               select(expression{"x"} > expression{1.0}, expression{1.0},
+                                      expression{"x"}));
+    std::stringstream ss;
+    printer p(ss);
+
+    expr.accept(p);
+
+    REQUIRE(ss.str() == "piecewise((x < 0): 0, if((x > 1), 1, x))");
+}
+
+TEST_CASE("shared nodes are counted once", "[dag]")
+{
+    using namespace drakmoor;
+    const expression x{"x"};
+    const auto square = x * x;
+
+    REQUIRE(node_count(square + square) == 3);
+    REQUIRE(node_count(expression{"x"} * expression{"x"}) == 3);
+}
+
+TEST_CASE("dag_evaluator agrees with eval_at", "[dag]")
+{
+    using namespace drakmoor;
+    const expression x{"x"};
+    const expression y{"y"};
+    const auto square = x * x;
+    std::vector<std::pair<expression, expression>> pieces;
+    pieces.emplace_back(x < expression{0.0}, expression{0.0} - square);
+    std::vector<expression> outputs{
+        square + square / y,
+        select(x > expression{1.0}, square, x - y),
+        make_piecewise(std::move(pieces), square * y)};
+
+    dag_evaluator evaluator{outputs};
+    // x, y and the square are shared; the two zero constants are separate nodes
+    REQUIRE(evaluator.size() == 15);
+    for (const auto& point : std::vector<arg_map>{{{"x", -2.0}, {"y", 3.0}},
+                                                  {{"x", 0.5}, {"y", 4.0}},
+                                                  {{"x", 3.0}, {"y", -1.0}}})
+    {
+        const auto& values = evaluator.eval_at(point);
+        REQUIRE(values.size() == outputs.size());
+        for (std::size_t i = 0; i < outputs.size(); ++i)
+        {
+            REQUIRE(values[i] == Approx(outputs[i].eval_at(point)));
+        }
+    }
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace io
+{
+///////////////////////////////////////////////////////////////////////////
+//  A file mapped read-only into memory, for parsing without a copy
+///////////////////////////////////////////////////////////////////////////
+class mapped_file
+{
+public:
+    // throws std::system_error if the file cannot be opened or mapped
+    explicit mapped_file(std::string const& path);
+    ~mapped_file();
+
+    mapped_file(mapped_file const&) = delete;
+    mapped_file& operator=(mapped_file const&) = delete;
+
+    char const* begin() const { return data_; }
+    char const* end() const { return data_ + size_; }
+    std::size_t size() const { return size_; }
+
+private:
+    char const* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+} // namespace io
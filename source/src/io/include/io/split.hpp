@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace io
+{
+// Cuts [first, last) into about `count` pieces of similar size, each but
+// the last ending after a newline, so that every piece holds whole lines.
+// Returns the boundaries: piece i is [cuts[i], cuts[i + 1]). Empty input
+// has no pieces, and a buffer with fewer newlines than pieces has fewer.
+std::vector<char const*> split_lines(char const* first, char const* last,
+                                     std::size_t count);
+} // namespace io
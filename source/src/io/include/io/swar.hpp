@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+
+namespace io::swar
+{
+///////////////////////////////////////////////////////////////////////////
+//  SWAR (SIMD within a register) byte scanning: eight input bytes are
+//  handled as one 64-bit word, so a scan for a few byte values tests eight
+//  bytes per step without intrinsics. Everything is constexpr, so compile
+//  time parsers can scan with it too.
+///////////////////////////////////////////////////////////////////////////
+inline constexpr std::uint64_t low_bits = 0x0101010101010101ull;
+inline constexpr std::uint64_t high_bits = 0x8080808080808080ull;
+
+// Byte i of the input ends up in bits [8i, 8i+8), independent of host byte
+// order, so the lowest set bit of a mask always points at the earliest byte.
+// Compilers recognize the pattern and emit a single load.
+constexpr std::uint64_t load_word(char const* p)
+{
+    auto const byte = [p](int i) {
+        return std::uint64_t{static_cast<unsigned char>(p[i])} << (8 * i);
+    };
+    return byte(0) | byte(1) | byte(2) | byte(3) | byte(4) | byte(5) | byte(6) | byte(7);
+}
+
+// High bit of each byte set exactly where that byte of `word` equals c
+constexpr std::uint64_t match_byte(std::uint64_t word, unsigned char c)
+{
+    std::uint64_t const x = word ^ (low_bits * c);
+    std::uint64_t const t = (x & ~high_bits) + ~high_bits;
+    return ~(t | x | ~high_bits);
+}
+
+// The index of the lowest set bit; x must not be 0. Divided by 8, the
+// index of the earliest matching byte of a mask from match_byte.
+constexpr int count_trailing_zeros(std::uint64_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(x);
+#else
+    int n = 0;
+    while ((x & 1u) == 0)
+    {
+        x >>= 1;
+        ++n;
+    }
+    return n;
+#endif
+}
+} // namespace io::swar
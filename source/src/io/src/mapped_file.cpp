@@ -0,0 +1,48 @@
+#include "io/mapped_file.hpp"
+
+#include <cerrno>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace io
+{
+mapped_file::mapped_file(std::string const& path)
+{
+    int const fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::system_error(errno, std::generic_category(), path);
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0)
+    {
+        int const error = errno;
+        ::close(fd);
+        throw std::system_error(error, std::generic_category(), path);
+    }
+    size_ = static_cast<std::size_t>(st.st_size);
+
+    if (size_ != 0)
+    {
+        void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED)
+        {
+            int const error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), path);
+        }
+        ::madvise(p, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<char const*>(p);
+    }
+    ::close(fd);
+}
+
+mapped_file::~mapped_file()
+{
+    if (data_ != nullptr)
+        ::munmap(const_cast<char*>(data_), size_);
+}
+} // namespace io
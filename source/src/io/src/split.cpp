@@ -0,0 +1,27 @@
+#include "io/split.hpp"
+
+#include <cstring>
+
+namespace io
+{
+std::vector<char const*> split_lines(char const* first, char const* last,
+                                     std::size_t count)
+{
+    std::vector<char const*> cuts{first};
+    std::size_t const size = static_cast<std::size_t>(last - first);
+    for (std::size_t i = 1; i < count; ++i)
+    {
+        char const* p = first + size / count * i;
+        if (p <= cuts.back())
+            continue;
+        auto const rest = static_cast<std::size_t>(last - p);
+        p = static_cast<char const*>(std::memchr(p, '\n', rest));
+        if (p == nullptr)
+            break;
+        cuts.push_back(p + 1);
+    }
+    if (cuts.back() != last)
+        cuts.push_back(last);
+    return cuts;
+}
+} // namespace io
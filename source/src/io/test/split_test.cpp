@@ -0,0 +1,74 @@
+#include "io/split.hpp"
+
+#include <catch.hpp>
+
+#include <string>
+#include <vector>
+
+namespace
+{
+// The pieces split_lines cuts text into
+std::vector<std::string> pieces(std::string const& text, std::size_t count)
+{
+    auto const cuts = io::split_lines(text.data(), text.data() + text.size(), count);
+    REQUIRE(!cuts.empty());
+    CHECK(cuts.front() == text.data());
+    CHECK(cuts.back() == text.data() + text.size());
+
+    std::vector<std::string> result;
+    for (std::size_t i = 0; i + 1 < cuts.size(); ++i)
+        result.emplace_back(cuts[i], cuts[i + 1]);
+    return result;
+}
+} // namespace
+
+TEST_CASE("pieces hold whole lines", "[split]")
+{
+    std::string text;
+    for (int n = 0; n < 100; ++n)
+        text += "line " + std::to_string(n) + "\n";
+
+    auto const p = pieces(text, 8);
+    CHECK(p.size() == 8);
+    std::string joined;
+    for (auto const& piece : p)
+    {
+        REQUIRE(!piece.empty());
+        CHECK(piece.back() == '\n');
+        joined += piece;
+    }
+    CHECK(joined == text);
+}
+
+TEST_CASE("the last line need not end with a newline", "[split]")
+{
+    auto const p = pieces("a\nb\nc\nlast", 4);
+    REQUIRE(!p.empty());
+    CHECK(p.back().find("last") != std::string::npos);
+    std::string joined;
+    for (auto const& piece : p)
+        joined += piece;
+    CHECK(joined == "a\nb\nc\nlast");
+}
+
+TEST_CASE("text without newlines is a single piece", "[split]")
+{
+    auto const p = pieces("no newline at all", 16);
+    REQUIRE(p.size() == 1);
+    CHECK(p[0] == "no newline at all");
+}
+
+TEST_CASE("empty text has no pieces", "[split]")
+{
+    CHECK(pieces("", 8).empty());
+
+    auto const cuts = io::split_lines(nullptr, nullptr, 8);
+    REQUIRE(cuts.size() == 1);
+}
+
+TEST_CASE("there are never more pieces than lines", "[split]")
+{
+    auto const p = pieces("x\ny\n", 64);
+    CHECK(p.size() <= 2);
+    CHECK(p.size() >= 1);
+}
@@ -0,0 +1,226 @@
+#include "roman.hpp"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+namespace roman
+{
+namespace
+{
+///////////////////////////////////////////////////////////////////////////
+//  Reading
+//
+//  A numeral is four groups, thousands to ones, each optional and each
+//  spelled with the group's one, five and ten letters (M alone for the
+//  thousands). A state is a group and how far into it the DFA is. Letters
+//  of a lower group start that group. Every transition carries what the
+//  letter adds to the value, so that the 'V' of "IV" adds 3.
+///////////////////////////////////////////////////////////////////////////
+enum letter : std::uint8_t
+{
+    none, // not a roman letter
+    I, V, X, L, C, D, M,
+    letters
+};
+
+constexpr std::array<std::uint8_t, 256> make_letters()
+{
+    std::array<std::uint8_t, 256> table{};
+    table['I'] = I;
+    table['V'] = V;
+    table['X'] = X;
+    table['L'] = L;
+    table['C'] = C;
+    table['D'] = D;
+    table['M'] = M;
+    return table;
+}
+
+constexpr auto letter_of = make_letters();
+
+// How far into a group: after the letters named by the digits, 1 for the
+// one and 5 for the five. Nothing may follow `done` in the group.
+enum step : std::uint8_t
+{
+    start, s1, s11, s111, s5, s51, s511, s5111, done,
+    steps
+};
+
+struct group
+{
+    std::uint8_t one, five, ten;
+    std::uint16_t unit;
+};
+
+constexpr group groups[] = {
+    {M, none, none, 1000},
+    {C, D, M, 100},
+    {X, L, C, 10},
+    {I, V, X, 1},
+};
+
+constexpr std::size_t group_count = std::size(groups);
+
+// 0 rejects and absorbs, the others are group * steps + step + 1
+constexpr std::uint8_t reject = 0;
+constexpr std::size_t states = group_count * steps + 1;
+constexpr std::uint8_t initial = 1; // the thousands, at their start
+
+struct transition
+{
+    std::uint8_t next = reject;
+    std::uint16_t add = 0;
+};
+
+constexpr std::uint8_t state_of(std::size_t g, step s)
+{
+    return static_cast<std::uint8_t>(g * steps + s + 1);
+}
+
+// The transition within group g from s on l, if there is one
+constexpr transition within(std::size_t g, step s, std::uint8_t l)
+{
+    group const& gr = groups[g];
+    auto const to = [&](step next, unsigned units) {
+        return transition{state_of(g, next), static_cast<std::uint16_t>(units * gr.unit)};
+    };
+
+    if (l == none)
+        return {};
+    if (l == gr.one)
+    {
+        switch (s)
+        {
+        case start: return to(s1, 1);
+        case s1: return to(s11, 1);
+        case s11: return to(s111, 1);
+        case s5: return to(s51, 1);
+        case s51: return to(s511, 1);
+        case s511: return to(s5111, 1);
+        case s111:
+        case s5111:
+        case done:
+        case steps: return {};
+        }
+    }
+    if (l == gr.five)
+    {
+        if (s == start)
+            return to(s5, 5);
+        if (s == s1)
+            return to(done, 3); // 4, after 1
+    }
+    if (l == gr.ten && s == s1)
+        return to(done, 8); // 9, after 1
+    return {};
+}
+
+struct dfa
+{
+    transition table[states][letters];
+    bool accepts[states];
+};
+
+constexpr dfa make_dfa()
+{
+    dfa d{};
+    for (std::size_t g = 0; g < group_count; ++g)
+    {
+        for (std::uint8_t st = start; st < steps; ++st)
+        {
+            auto const s = static_cast<step>(st);
+            std::uint8_t const from = state_of(g, s);
+            d.accepts[from] = from != initial;
+            for (std::uint8_t l = I; l < letters; ++l)
+            {
+                transition t = within(g, s, l);
+                for (std::size_t lower = g + 1; t.next == reject && lower < group_count;
+                     ++lower)
+                    t = within(lower, start, l);
+                d.table[from][l] = t;
+            }
+        }
+    }
+    return d;
+}
+
+constexpr dfa numerals = make_dfa();
+
+inline unsigned read(std::string_view numeral)
+{
+    if (numeral.size() > max_length)
+        return 0;
+
+    std::uint8_t state = initial;
+    unsigned value = 0;
+    for (char c : numeral)
+    {
+        transition const t =
+            numerals.table[state][letter_of[static_cast<unsigned char>(c)]];
+        state = t.next;
+        value += t.add;
+    }
+    return numerals.accepts[state] ? value : 0;
+}
+
+///////////////////////////////////////////////////////////////////////////
+//  Writing
+//
+//  The numeral of every digit of every group, padded to four characters so
+//  that each is copied whole and the length advanced by its size. The
+//  padding stays within max_length: at most 11 characters precede the ones.
+///////////////////////////////////////////////////////////////////////////
+struct digit
+{
+    char text[4];
+    std::uint8_t size;
+};
+
+constexpr digit digits[group_count][10] = {
+    {{"", 0}, {"M", 1}, {"MM", 2}, {"MMM", 3}},
+    {{"", 0}, {"C", 1}, {"CC", 2}, {"CCC", 3}, {"CD", 2},
+     {"D", 1}, {"DC", 2}, {"DCC", 3}, {{'D', 'C', 'C', 'C'}, 4}, {"CM", 2}},
+    {{"", 0}, {"X", 1}, {"XX", 2}, {"XXX", 3}, {"XL", 2},
+     {"L", 1}, {"LX", 2}, {"LXX", 3}, {{'L', 'X', 'X', 'X'}, 4}, {"XC", 2}},
+    {{"", 0}, {"I", 1}, {"II", 2}, {"III", 3}, {"IV", 2},
+     {"V", 1}, {"VI", 2}, {"VII", 3}, {{'V', 'I', 'I', 'I'}, 4}, {"IX", 2}},
+};
+} // namespace
+
+std::optional<unsigned> roman_to_uint(std::string_view numeral)
+{
+    if (unsigned const value = read(numeral))
+        return value;
+    return std::nullopt;
+}
+
+std::size_t roman_to_uint(std::string_view const* first, std::string_view const* last,
+                          unsigned* values)
+{
+    std::size_t valid = 0;
+    for (; first != last; ++first, ++values)
+    {
+        *values = read(*first);
+        valid += *values != 0;
+    }
+    return valid;
+}
+
+std::size_t uint_to_roman(unsigned value, char* out)
+{
+    if (value == 0 || value > 3999)
+        return 0;
+
+    unsigned const place[group_count] = {value / 1000, value / 100 % 10, value / 10 % 10,
+                                         value % 10};
+    std::size_t size = 0;
+    for (std::size_t g = 0; g < group_count; ++g)
+    {
+        digit const& d = digits[g][place[g]];
+        std::memcpy(out + size, d.text, sizeof(d.text));
+        size += d.size;
+    }
+    return size;
+}
+} // namespace roman
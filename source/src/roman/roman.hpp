@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string_view>
+
+namespace roman
+{
+///////////////////////////////////////////////////////////////////////////
+//  Roman numeral conversion without a parser
+//
+//  Numerals are read by a DFA over a precomputed transition table, and
+//  written from a table of the numerals of every digit. Neither direction
+//  allocates. Only canonical numerals of 1 to 3999 are accepted: "IIII",
+//  "VX" and "MMMM" are not, unlike with the X3 grammar, which takes any
+//  number of 'M's.
+///////////////////////////////////////////////////////////////////////////
+
+// The longest numeral, MMMDCCCLXXXVIII
+inline constexpr std::size_t max_length = 15;
+
+// The value of a whole numeral, if it is one
+std::optional<unsigned> roman_to_uint(std::string_view numeral);
+
+// Converts numerals [first, last) into values, 0 for those that are not
+// numerals. Returns how many were.
+std::size_t roman_to_uint(std::string_view const* first, std::string_view const* last,
+                          unsigned* values);
+
+// Writes the numeral of value to out, which holds at least max_length
+// characters, and returns its length, or 0 if value is not within 1..3999.
+// The characters of out past the numeral may be overwritten.
+std::size_t uint_to_roman(unsigned value, char* out);
+} // namespace roman
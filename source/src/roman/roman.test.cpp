@@ -0,0 +1,100 @@
+#include "roman.hpp"
+
+#include "x3_roman_numeral.hpp"
+
+#include <catch.hpp>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+// The value the X3 grammar reads from the whole of numeral, if it does
+std::optional<unsigned> x3_roman(std::string_view numeral)
+{
+    unsigned value = 0;
+    auto iter = numeral.begin();
+    if (!boost::spirit::x3::parse(iter, numeral.end(), client::parser::roman, value) ||
+        iter != numeral.end())
+        return std::nullopt;
+    return value;
+}
+
+std::string to_roman(unsigned value)
+{
+    char out[roman::max_length];
+    return std::string(out, roman::uint_to_roman(value, out));
+}
+} // namespace
+
+TEST_CASE("numerals agree with the X3 grammar for 1 to 3999", "[roman]")
+{
+    for (unsigned n = 1; n <= 3999; ++n)
+    {
+        std::string const numeral = to_roman(n);
+        REQUIRE(!numeral.empty());
+        REQUIRE(numeral.size() <= roman::max_length);
+        REQUIRE(x3_roman(numeral) == n);
+        REQUIRE(roman::roman_to_uint(numeral) == n);
+    }
+
+    CHECK(to_roman(1994) == "MCMXCIV");
+    CHECK(to_roman(3888) == "MMMDCCCLXXXVIII");
+}
+
+TEST_CASE("every short string is read as the X3 grammar reads it", "[roman]")
+{
+    // All strings of up to five roman letters, including the non-canonical
+    // ones; the X3 grammar also reads "" as 0 and "MMMM" as 4000
+    std::string const letters = "IVXLCDM";
+    std::vector<std::string> strings{""};
+    for (std::size_t first = 0; first < strings.size(); ++first)
+    {
+        if (strings[first].size() == 5)
+            break;
+        for (char c : letters)
+            strings.push_back(strings[first] + c);
+    }
+
+    std::size_t numerals = 0;
+    for (auto const& s : strings)
+    {
+        auto expected = x3_roman(s);
+        if (expected && (*expected == 0 || *expected > 3999))
+            expected = std::nullopt;
+        INFO(s);
+        REQUIRE(roman::roman_to_uint(s) == expected);
+        numerals += expected.has_value();
+    }
+    CHECK(numerals > 0);
+}
+
+TEST_CASE("malformed numerals are rejected", "[roman]")
+{
+    for (std::string_view s : {"", "IIII", "VX", "IL", "XM", "MMMM", "iv", "X I", "XIV ",
+                               "MMMDCCCLXXXVIIII", "12"})
+    {
+        INFO(s);
+        CHECK(!roman::roman_to_uint(s));
+    }
+
+    char out[roman::max_length];
+    CHECK(roman::uint_to_roman(0, out) == 0);
+    CHECK(roman::uint_to_roman(4000, out) == 0);
+}
+
+TEST_CASE("numerals are converted in batches", "[roman]")
+{
+    std::string_view const numerals[] = {"XLII", "nope", "MMXXVI", "", "IX"};
+    unsigned values[std::size(numerals)];
+
+    auto const valid = roman::roman_to_uint(std::begin(numerals), std::end(numerals),
+                                            values);
+    CHECK(valid == 3);
+    CHECK(values[0] == 42);
+    CHECK(values[1] == 0);
+    CHECK(values[2] == 2026);
+    CHECK(values[3] == 0);
+    CHECK(values[4] == 9);
+}
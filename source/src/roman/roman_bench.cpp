@@ -0,0 +1,98 @@
+// Roman numeral conversion, the library against the X3 grammar.
+//
+//   roman.bench [numerals] [repeat]
+//
+// Converts `numerals` (default 10000000) numerals, cycling through 1 to
+// 3999, `repeat` (default 3) times, keeping the fastest run: with the X3
+// grammar, one at a time and in a batch with the library, and back to
+// numerals with the library. Configure with -DCMAKE_BUILD_TYPE=Release for
+// meaningful numbers.
+#include "roman.hpp"
+
+#include "x3_roman_numeral.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+template <typename F>
+void run(char const* label, std::size_t count, unsigned repeat, F&& convert)
+{
+    double best = 0;
+    unsigned long long sum = 0;
+    for (unsigned r = 0; r < repeat; ++r)
+    {
+        auto const start = std::chrono::steady_clock::now();
+        sum = convert();
+        std::chrono::duration<double> const elapsed =
+            std::chrono::steady_clock::now() - start;
+        best = r == 0 ? elapsed.count() : std::min(best, elapsed.count());
+    }
+
+    double const rate = static_cast<double>(count) / best;
+    std::printf("%-10s %8.3f s %12.0f numerals/s  (%llu)\n", label, best, rate, sum);
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::size_t const count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    unsigned const repeat =
+        std::max(1u, argc > 2 ? static_cast<unsigned>(std::atoi(argv[2])) : 3u);
+
+    // One buffer of numerals, and views of them
+    std::string text;
+    std::vector<std::size_t> offsets{0};
+    for (std::size_t n = 0; n < count; ++n)
+    {
+        char out[roman::max_length];
+        text.append(out, roman::uint_to_roman(static_cast<unsigned>(n % 3999 + 1), out));
+        offsets.push_back(text.size());
+    }
+    std::vector<std::string_view> numerals;
+    numerals.reserve(count);
+    for (std::size_t n = 0; n < count; ++n)
+        numerals.emplace_back(text.data() + offsets[n], offsets[n + 1] - offsets[n]);
+
+    run("x3", count, repeat, [&] {
+        unsigned long long sum = 0;
+        for (auto const numeral : numerals)
+        {
+            unsigned value = 0;
+            auto iter = numeral.begin();
+            boost::spirit::x3::parse(iter, numeral.end(), client::parser::roman, value);
+            sum += value;
+        }
+        return sum;
+    });
+
+    run("dfa", count, repeat, [&] {
+        unsigned long long sum = 0;
+        for (auto const numeral : numerals)
+            sum += roman::roman_to_uint(numeral).value_or(0);
+        return sum;
+    });
+
+    std::vector<unsigned> values(count);
+    run("dfa.batch", count, repeat, [&] {
+        roman::roman_to_uint(numerals.data(), numerals.data() + count, values.data());
+        unsigned long long sum = 0;
+        for (unsigned v : values)
+            sum += v;
+        return sum;
+    });
+
+    run("to_roman", count, repeat, [&] {
+        unsigned long long sum = 0;
+        char out[roman::max_length];
+        for (std::size_t n = 0; n < count; ++n)
+            sum += roman::uint_to_roman(static_cast<unsigned>(n % 3999 + 1), out);
+        return sum;
+    });
+}
@@ -0,0 +1,285 @@
+// Parser throughput of every X3 grammar in the tree, as JSON.
+//
+//   x3-bench [megabytes] [repeat] [benchmark...]
+//
+// Generates about `megabytes` (default 16) MB of input for each grammar and
+// parses it `repeat` (default 3) times, keeping the fastest run. Allocations
+// are counted with alloc_tracking, during the first run. Every run must parse
+// as many items as were generated, or the benchmark fails.
+// Only the named benchmarks run if any are given. The JSON on stdout is
+// meant to be kept and compared across commits. Configure with
+// -DCMAKE_BUILD_TYPE=Release for meaningful numbers.
+#include "alloc_tracking.hpp"
+#include "ast.hpp"
+#include "employee.hpp"
+#include "employee_bulk.hpp"
+#include "funexpr-parser/funexpr_def.hpp"
+#include "rexpr/bulk.hpp"
+#include "roman.hpp"
+#include "x3_roman_numeral.hpp"
+
+#include <boost/spirit/home/x3.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+namespace x3 = boost::spirit::x3;
+
+///////////////////////////////////////////////////////////////////////////
+//  Synthetic inputs
+///////////////////////////////////////////////////////////////////////////
+std::string employees(std::size_t bytes, std::size_t& items)
+{
+    char const* const forenames[] = {"Ada", "Grace", "Linus", "Margaret", "Dennis"};
+    char const* const surnames[] = {"Lovelace", "Hopper", "Torvalds", "Hamilton"};
+
+    std::string text;
+    for (std::size_t n = 0; text.size() < bytes; ++n)
+    {
+        text += "employee{" + std::to_string(20 + n % 45) + ", \"";
+        text += forenames[n % 5];
+        text += "\", \"";
+        text += surnames[n % 4];
+        text += "\", " + std::to_string(n % 9000) + ".5}\n";
+        items = n + 1;
+    }
+    return text;
+}
+
+std::string rexprs(std::size_t bytes, std::size_t& items)
+{
+    std::string text;
+    for (std::size_t n = 0; text.size() < bytes; ++n)
+    {
+        text += "{\n    \"name\" = \"service-" + std::to_string(n) + "\"\n";
+        text += "    \"replicas\" = " + std::to_string(n % 7 + 1) + "\n";
+        text += "    \"limits\" = { \"cpu\" = 0.5 \"memory\" = \"512 MB\" }\n";
+        text += "    \"ports\" = [80 443]\n}\n";
+        items = n + 1;
+    }
+    return text;
+}
+
+std::string to_roman(unsigned n)
+{
+    static char const* const thousands[] = {"", "M", "MM", "MMM"};
+    static char const* const hundreds[] = {"",  "C",  "CC",  "CCC",  "CD",
+                                           "D", "DC", "DCC", "DCCC", "CM"};
+    static char const* const tens[] = {"",  "X",  "XX",  "XXX",  "XL",
+                                       "L", "LX", "LXX", "LXXX", "XC"};
+    static char const* const ones[] = {"",  "I",  "II",  "III",  "IV",
+                                       "V", "VI", "VII", "VIII", "IX"};
+    return std::string(thousands[n / 1000]) + hundreds[n / 100 % 10] +
+           tens[n / 10 % 10] + ones[n % 10];
+}
+
+std::string romans(std::size_t bytes, std::size_t& items)
+{
+    std::string text;
+    for (unsigned n = 0; text.size() < bytes; ++n)
+    {
+        text += to_roman(n % 3999 + 1) + '\n';
+        items = n + 1;
+    }
+    return text;
+}
+
+std::string atoms(std::size_t bytes, std::size_t& items)
+{
+    char const* const names[] = {"x", "y", "rate", "theta"};
+
+    std::string text;
+    for (std::size_t n = 0; text.size() < bytes; ++n)
+    {
+        if (n % 2 == 0)
+            text += std::to_string(n % 1000) + ".125 ";
+        else
+            text += names[n % 4] + std::string(" ");
+        items = n + 1;
+    }
+    return text;
+}
+
+///////////////////////////////////////////////////////////////////////////
+//  Parsing loops, returning the number of items parsed
+///////////////////////////////////////////////////////////////////////////
+char const* skip_space(char const* first, char const* last)
+{
+    while (first != last && std::isspace(static_cast<unsigned char>(*first)))
+        ++first;
+    return first;
+}
+
+// Parses items with p, skipping whitespace, one at a time, until the input
+// ends or p fails or matches nothing
+template <typename Parser, typename Attribute>
+std::size_t each(std::string const& text, Parser const& p, Attribute& attr)
+{
+    std::size_t count = 0;
+    char const* const last = text.data() + text.size();
+    for (char const* iter = skip_space(text.data(), last); iter != last; ++count)
+    {
+        char const* const start = iter;
+        attr = Attribute();
+        if (!x3::phrase_parse(iter, last, p, x3::ascii::space, attr) || iter == start)
+            break;
+    }
+    return count;
+}
+
+std::size_t parse_employees(std::string const& text)
+{
+    client::ast::employee emp;
+    return each(text, client::employee(), emp);
+}
+
+std::size_t parse_employee_table(std::string const& text)
+{
+    client::employee_table table;
+    return client::parse_employees(text.data(), text.data() + text.size(), table).count;
+}
+
+std::size_t parse_rexprs(std::string const& text)
+{
+    return rexpr::parse_all(text.data(), text.data() + text.size(),
+                            [](rexpr::ast::rexpr&&) {}, std::cerr)
+        .count;
+}
+
+// Numerals one whitespace-separated token at a time: with a skipper, the
+// grammar would skip the whitespace between its symbol groups and read
+// "C\nX" as 110
+std::size_t parse_romans(std::string const& text)
+{
+    std::size_t count = 0;
+    char const* const last = text.data() + text.size();
+    for (char const* iter = skip_space(text.data(), last); iter != last;
+         iter = skip_space(iter, last))
+    {
+        char const* const start = iter;
+        unsigned value = 0;
+        if (!x3::parse(iter, last, client::parser::roman, value) || iter == start ||
+            (iter != last && !std::isspace(static_cast<unsigned char>(*iter))))
+            break;
+        ++count;
+    }
+    return count;
+}
+
+// The roman library, numeral by numeral as the grammar reads them
+std::size_t parse_romans_dfa(std::string const& text)
+{
+    std::size_t count = 0;
+    char const* const last = text.data() + text.size();
+    for (char const* iter = skip_space(text.data(), last); iter != last;
+         iter = skip_space(iter, last))
+    {
+        char const* const start = iter;
+        while (iter != last && !std::isspace(static_cast<unsigned char>(*iter)))
+            ++iter;
+        if (!roman::roman_to_uint(std::string_view(start, std::size_t(iter - start))))
+            break;
+        ++count;
+    }
+    return count;
+}
+
+std::size_t parse_atoms(std::string const& text)
+{
+    funexpr::ast::atom atom;
+    return each(text, funexpr::parser::atom, atom);
+}
+
+///////////////////////////////////////////////////////////////////////////
+//  Measurement
+///////////////////////////////////////////////////////////////////////////
+struct benchmark
+{
+    char const* name;
+    std::string (*generate)(std::size_t bytes, std::size_t& items);
+    std::size_t (*parse)(std::string const& text);
+};
+
+benchmark const benchmarks[] = {
+    {"employee", employees, parse_employees},
+    {"employee.table", employees, parse_employee_table},
+    {"rexpr", rexprs, parse_rexprs},
+    {"roman", romans, parse_romans},
+    {"roman.dfa", romans, parse_romans_dfa},
+    {"funexpr.atom", atoms, parse_atoms},
+};
+
+// False if a run did not parse every generated item
+bool run(benchmark const& b, std::size_t bytes, unsigned repeat, bool first)
+{
+    std::size_t generated = 0;
+    std::string const text = b.generate(bytes, generated);
+
+    double best = 0;
+    std::size_t items = 0;
+    alloc_tracking::alloc_stats allocs;
+    for (unsigned r = 0; r < repeat; ++r)
+    {
+        alloc_tracking::scope counted;
+        auto const start = std::chrono::steady_clock::now();
+        items = b.parse(text);
+        std::chrono::duration<double> const elapsed =
+            std::chrono::steady_clock::now() - start;
+        if (items != generated)
+        {
+            std::fprintf(stderr, "%s: parsed %zu of %zu items\n", b.name, items,
+                         generated);
+            return false;
+        }
+
+        if (r == 0)
+        {
+            allocs = counted.stats();
+            best = elapsed.count();
+        }
+        best = std::min(best, elapsed.count());
+    }
+
+    double const mb = static_cast<double>(text.size()) / (1024.0 * 1024.0);
+    double const per_item = items != 0 ? 1.0 / static_cast<double>(items) : 0.0;
+    std::printf("%s    {\"benchmark\": \"%s\", \"bytes\": %zu, \"items\": %zu, "
+                "\"seconds\": %.6f, \"mb_per_s\": %.2f, \"items_per_s\": %.0f, "
+                "\"allocations_per_item\": %.3f, \"allocated_bytes_per_item\": %.1f, "
+                "\"peak_bytes\": %zu}",
+                first ? "" : ",\n", b.name, text.size(), items, best, mb / best,
+                static_cast<double>(items) / best,
+                static_cast<double>(allocs.allocations) * per_item,
+                static_cast<double>(allocs.bytes) * per_item, allocs.peak);
+    return true;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::size_t const megabytes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 16;
+    unsigned const repeat =
+        std::max(1u, argc > 2 ? static_cast<unsigned>(std::atoi(argv[2])) : 3u);
+    std::vector<std::string> const only(argv + std::min(argc, 3), argv + argc);
+
+    std::printf("{\n  \"megabytes\": %zu,\n  \"repeat\": %u,\n  \"results\": [\n",
+                megabytes, repeat);
+    bool first = true;
+    for (auto const& b : benchmarks)
+    {
+        if (!only.empty() && std::find(only.begin(), only.end(), b.name) == only.end())
+            continue;
+        if (!run(b, megabytes * 1024 * 1024, repeat, first))
+            return 1;
+        first = false;
+    }
+    std::printf("\n  ]\n}\n");
+}
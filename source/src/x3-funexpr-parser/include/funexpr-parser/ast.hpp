@@ -2,6 +2,8 @@
 
 #include <boost/spirit/home/x3/support/ast/variant.hpp>
 
+#include <string>
+
 namespace funexpr::ast
 {
 namespace x3 = boost::spirit::x3;
@@ -12,6 +14,8 @@ using placeholder = std::string;
 
 struct atom : x3::variant<constant, placeholder>
 {
+    using base_type::base_type;
+    using base_type::operator=;
 };
 
 }
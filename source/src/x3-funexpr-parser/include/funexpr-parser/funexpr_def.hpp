@@ -1,5 +1,10 @@
 #pragma once
 
+#include "ast.hpp"
+#include "ast_adapted.hpp"
+
+#include <boost/spirit/home/x3.hpp>
+
 namespace funexpr::parser
 {
 namespace x3 = boost::spirit::x3;
@@ -7,6 +12,10 @@ namespace ascii = x3::ascii;
 
 using x3::lit;
 
+struct constant_class;
+struct placeholder_class;
+struct atom_class;
+
 x3::rule<constant_class, ast::constant> const constant = "constant";
 x3::rule<placeholder_class, ast::placeholder> const placeholder = "placeholder";
 x3::rule<atom_class, ast::atom> const atom = "atom";
@@ -15,4 +24,6 @@ auto const constant_def = x3::double_;
 auto const placeholder_def = +(ascii::char_('a', 'z'));
 
 auto const atom_def = constant | placeholder;
+
+BOOST_SPIRIT_DEFINE(constant, placeholder, atom)
 }
@@ -13,6 +13,7 @@ namespace client::parser
     namespace x3 = boost::spirit::x3;
 
     using iterator_type = std::string::const_iterator;
+    using pointer_iterator_type = char const*;
     using context_type = x3::phrase_parse_context<x3::ascii::space_type>::type;
 }
 
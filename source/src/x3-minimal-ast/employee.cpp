@@ -10,4 +10,5 @@
 namespace client::parser
 {
     BOOST_SPIRIT_INSTANTIATE(employee_type, iterator_type, context_type)
+    BOOST_SPIRIT_INSTANTIATE(employee_type, pointer_iterator_type, context_type)
 }
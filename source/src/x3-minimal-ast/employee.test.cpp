@@ -0,0 +1,172 @@
+#include "employee_bulk.hpp"
+#include "employee_table.hpp"
+
+#include <catch.hpp>
+
+#include <string>
+#include <vector>
+
+namespace
+{
+    client::bulk_result parse(std::string const& text, client::employee_table& table)
+    {
+        return client::parse_employees(text.data(), text.data() + text.size(), table);
+    }
+}
+
+TEST_CASE("records fill the table in order", "[employee]")
+{
+    client::employee_table table;
+    auto const result = parse(R"(employee{34, "Ada", "Lovelace", 1234.5}
+employee{85, "Grace", "Hopper", 99.25})",
+                              table);
+    CHECK(result.ok);
+    CHECK(result.count == 2);
+    REQUIRE(table.size() == 2);
+
+    CHECK(table.age(0) == 34);
+    CHECK(table.forename(0) == "Ada");
+    CHECK(table.surname(0) == "Lovelace");
+    CHECK(table.salary(0) == Approx(1234.5));
+    CHECK(table.age(1) == 85);
+    CHECK(table.forename(1) == "Grace");
+    CHECK(table.surname(1) == "Hopper");
+    CHECK(table.arena() == "AdaLovelaceGraceHopper");
+}
+
+TEST_CASE("whitespace around and inside records is skipped", "[employee]")
+{
+    client::employee_table table;
+    auto const result = parse("\n\t  employee { 1 ,\"A B\", \"C\" ,2 }   "
+                              "employee{3,\"D\",\"E\",4}\n\n  \t",
+                              table);
+    CHECK(result.ok);
+    REQUIRE(table.size() == 2);
+    CHECK(table.forename(0) == "A B"); // inside quotes, spaces are kept
+    CHECK(table.surname(0) == "C");
+    CHECK(table.salary(1) == Approx(4.0));
+}
+
+TEST_CASE("a malformed record stops the parse where it starts", "[employee]")
+{
+    std::string const good = R"(employee{1, "A", "B", 2})";
+    std::string const bad = R"(employee{1, "A", 2})";
+    std::string const text = good + "\n" + bad + "\n" + good;
+
+    client::employee_table table;
+    auto const result = parse(text, table);
+    CHECK_FALSE(result.ok);
+    CHECK(result.count == 1);
+    CHECK(result.error_offset == text.find(bad));
+    CHECK(table.size() == 1);
+}
+
+TEST_CASE("empty input holds no records", "[employee]")
+{
+    client::employee_table table;
+    for (std::string const text : {"", " \n\t "})
+    {
+        auto const result = parse(text, table);
+        CHECK(result.ok);
+        CHECK(result.count == 0);
+    }
+    CHECK(table.empty());
+}
+
+TEST_CASE("tables append and give employees back", "[employee]")
+{
+    client::employee_table first;
+    first.push_back(30, "Ada", "Lovelace", 10.0);
+
+    client::employee_table second;
+    second.push_back(40, "Grace", "Hopper", 20.0);
+    second.push_back(50, "", "X", 30.0);
+
+    first.append(std::move(second));
+    CHECK(second.empty());
+    REQUIRE(first.size() == 3);
+    CHECK(first.forename(1) == "Grace");
+    CHECK(first.forename(2).empty());
+    CHECK(first.surname(2) == "X");
+
+    client::ast::employee const e = first[1];
+    CHECK(e.age == 40);
+    CHECK(e.forename == "Grace");
+    CHECK(e.surname == "Hopper");
+    CHECK(e.salary == Approx(20.0));
+
+    // Appending to an empty table takes the other one over
+    client::employee_table empty;
+    empty.append(std::move(first));
+    CHECK(empty.size() == 3);
+    CHECK(empty.surname(0) == "Lovelace");
+
+    // The table taken over is left empty and usable
+    CHECK(first.empty());
+    first.push_back(60, "Alan", "Turing", 40.0);
+    REQUIRE(first.size() == 1);
+    CHECK(first.forename(0) == "Alan");
+    CHECK(first.surname(0) == "Turing");
+
+    // A reserved empty table keeps its own storage
+    client::employee_table reserved;
+    reserved.reserve(8, 64);
+    client::employee_table one;
+    one.push_back(1, "a", "b", 1.0);
+    reserved.append(std::move(one));
+    CHECK(reserved.size() == 1);
+    CHECK(reserved.surname(0) == "b");
+}
+
+TEST_CASE("join keeps the parts in order on any number of threads", "[employee]")
+{
+    auto const make_parts = [] {
+        std::vector<client::employee_table> parts(40);
+        for (std::size_t i = 0; i < parts.size(); ++i)
+        {
+            // Every third part is empty
+            for (std::size_t n = 0; n < i % 3 * 5; ++n)
+            {
+                std::string const name = std::to_string(i) + "." + std::to_string(n);
+                parts[i].push_back(int(i), name, "s" + name, double(n));
+            }
+        }
+        return parts;
+    };
+
+    client::employee_table expected;
+    for (auto& part : make_parts())
+        expected.append(std::move(part));
+    REQUIRE(expected.size() == 13 * 5 + 13 * 10);
+
+    for (unsigned threads : {1u, 2u, 4u, 7u, 100u})
+    {
+        INFO(threads);
+        auto const joined = client::employee_table::join(make_parts(), threads);
+        REQUIRE(joined.size() == expected.size());
+        CHECK(joined.ages() == expected.ages());
+        CHECK(joined.salaries() == expected.salaries());
+        CHECK(joined.arena() == expected.arena());
+        for (std::size_t i = 0; i < joined.size(); ++i)
+        {
+            REQUIRE(joined.forename(i) == expected.forename(i));
+            REQUIRE(joined.surname(i) == expected.surname(i));
+        }
+    }
+}
+
+TEST_CASE("join handles empty and missing parts", "[employee]")
+{
+    CHECK(client::employee_table::join({}, 4).empty());
+
+    std::vector<client::employee_table> parts(3);
+    auto const empty = client::employee_table::join(std::move(parts), 8);
+    CHECK(empty.empty());
+
+    std::vector<client::employee_table> one(2);
+    one[1].push_back(1, "a", "b", 2.0);
+    auto const joined = client::employee_table::join(std::move(one), 8);
+    REQUIRE(joined.size() == 1);
+    CHECK(joined.forename(0) == "a");
+    CHECK(joined.surname(0) == "b");
+}
@@ -0,0 +1,133 @@
+// Records per second of the per-line employee parser and of the bulk one.
+//
+//   x3-minimal-ast.bench [records]
+//
+// Generates `records` (default 10000000) employee records, one per line, and
+// parses them with getline plus the employee rule into ast::employee values,
+// and with parse_employees straight into an employee_table. Fails unless both
+// parse every record and agree on the totals. Configure with
+// -DCMAKE_BUILD_TYPE=Release for meaningful numbers.
+#include "ast.hpp"
+#include "employee.hpp"
+#include "employee_bulk.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    std::string generate(std::size_t records)
+    {
+        char const* const forenames[] = {"Ada", "Grace", "Linus", "Margaret", "Dennis"};
+        char const* const surnames[] = {"Lovelace", "Hopper", "Torvalds", "Hamilton"};
+
+        std::string text;
+        for (std::size_t n = 0; n < records; ++n)
+        {
+            text += "employee{" + std::to_string(20 + n % 45) + ", \"";
+            text += forenames[n % 5];
+            text += "\", \"";
+            text += surnames[n % 4];
+            text += "\", " + std::to_string(n % 9000) + ".5}\n";
+        }
+        return text;
+    }
+
+    struct totals
+    {
+        bool ok = true;
+        std::size_t count = 0;
+        long long ages = 0;
+        double salaries = 0;
+        std::size_t name_bytes = 0;
+
+        bool operator==(totals const& other) const
+        {
+            return ok == other.ok && count == other.count && ages == other.ages &&
+                   // Both sum the same values in the same order
+                   std::equal_to<double>()(salaries, other.salaries) &&
+                   name_bytes == other.name_bytes;
+        }
+    };
+
+    template <typename F>
+    totals run(char const* label, F&& parse)
+    {
+        auto const start = std::chrono::steady_clock::now();
+        totals const t = parse();
+        std::chrono::duration<double> const elapsed =
+            std::chrono::steady_clock::now() - start;
+
+        double const rate = static_cast<double>(t.count) / elapsed.count();
+        std::printf("%-6s %10zu records %8.3f s %12.0f records/s  (%lld %.1f %zu)\n",
+                    label, t.count, elapsed.count(), rate, t.ages, t.salaries,
+                    t.name_bytes);
+        return t;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::size_t const records = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    std::string const text = generate(records);
+
+    totals const line = run("line", [&] {
+        using boost::spirit::x3::ascii::space;
+        using iterator_type = std::string::const_iterator;
+
+        std::vector<client::ast::employee> employees;
+        std::istringstream in(text);
+        totals t;
+        std::string str;
+        while (getline(in, str))
+        {
+            client::ast::employee emp;
+            iterator_type iter = str.begin();
+            iterator_type const end = str.end();
+            if (!phrase_parse(iter, end, client::employee(), space, emp) || iter != end)
+            {
+                t.ok = false;
+                break;
+            }
+            employees.push_back(std::move(emp));
+        }
+
+        t.count = employees.size();
+        for (auto const& e : employees)
+        {
+            t.ages += e.age;
+            t.salaries += e.salary;
+            t.name_bytes += e.forename.size() + e.surname.size();
+        }
+        return t;
+    });
+
+    totals const bulk = run("bulk", [&] {
+        client::employee_table table;
+        auto const result =
+            client::parse_employees(text.data(), text.data() + text.size(), table);
+
+        totals t;
+        t.ok = result.ok;
+        t.count = table.size();
+        for (int age : table.ages())
+            t.ages += age;
+        for (double salary : table.salaries())
+            t.salaries += salary;
+        t.name_bytes = table.arena().size();
+        return t;
+    });
+
+    if (!line.ok || !bulk.ok || line.count != records || !(line == bulk))
+    {
+        std::fprintf(stderr, "the parsers disagree or failed\n");
+        return 1;
+    }
+    return 0;
+}
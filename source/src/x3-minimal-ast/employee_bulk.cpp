@@ -0,0 +1,83 @@
+#include "employee_bulk.hpp"
+#include "employee_grammar.hpp"
+
+#include <boost/fusion/include/adapt_struct.hpp>
+#include <boost/spirit/home/x3.hpp>
+
+#include <cctype>
+#include <string_view>
+
+namespace client::parser
+{
+    // An employee record whose names are still ranges of the buffer
+    struct employee_view
+    {
+        int age;
+        boost::iterator_range<char const*> forename;
+        boost::iterator_range<char const*> surname;
+        double salary;
+    };
+}
+
+BOOST_FUSION_ADAPT_STRUCT(client::parser::employee_view,
+    age, forename, surname, salary
+)
+
+namespace client
+{
+    namespace
+    {
+        ///////////////////////////////////////////////////////////////////////
+        //  The employee grammar, without copying names
+        ///////////////////////////////////////////////////////////////////////
+        namespace grammar
+        {
+            namespace x3 = boost::spirit::x3;
+
+            x3::rule<class employee_view, parser::employee_view> const employee =
+                "employee";
+
+            auto const employee_def =
+                parser::employee_record([](auto const& p) { return x3::raw[p]; });
+
+            BOOST_SPIRIT_DEFINE(employee)
+        }
+
+        std::string_view view(boost::iterator_range<char const*> const& range)
+        {
+            return {range.begin(), range.size()};
+        }
+
+        bool is_space(char c)
+        {
+            return std::isspace(static_cast<unsigned char>(c)) != 0;
+        }
+    }
+
+    bulk_result parse_employees(char const* first, char const* last,
+                                employee_table& table)
+    {
+        using boost::spirit::x3::ascii::space;
+
+        bulk_result result;
+        char const* iter = first;
+        while (iter != last && is_space(*iter))
+            ++iter;
+
+        parser::employee_view record;
+        while (iter != last)
+        {
+            char const* const start = iter;
+            if (!phrase_parse(iter, last, grammar::employee, space, record))
+            {
+                result.ok = false;
+                result.error_offset = static_cast<std::size_t>(start - first);
+                return result;
+            }
+            table.push_back(record.age, view(record.forename), view(record.surname),
+                            record.salary);
+            ++result.count;
+        }
+        return result;
+    }
+}
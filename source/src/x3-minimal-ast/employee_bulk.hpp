@@ -0,0 +1,26 @@
+#pragma once
+
+#include "employee_table.hpp"
+
+#include <cstddef>
+
+namespace client
+{
+    ///////////////////////////////////////////////////////////////////////////
+    //  Bulk parsing: a buffer holding any number of employee records
+    ///////////////////////////////////////////////////////////////////////////
+    struct bulk_result
+    {
+        bool ok = true;
+        std::size_t count = 0;        // records parsed successfully
+        std::size_t error_offset = 0; // where the failing record starts, if !ok
+    };
+
+    // Parses the employee records in [first, last), separated by any
+    // whitespace, and appends them to table. The names are copied straight
+    // from the buffer into the table's arena; no ast::employee is built.
+    // Stops at the first malformed record, leaving the table holding the
+    // records before it.
+    bulk_result parse_employees(char const* first, char const* last,
+                                employee_table& table);
+}
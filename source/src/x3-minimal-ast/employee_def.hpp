@@ -12,6 +12,7 @@
 #include "ast.hpp"
 #include "ast_adapted.hpp"
 #include "employee.hpp"
+#include "employee_grammar.hpp"
 
 namespace client
 {
@@ -23,25 +24,9 @@ namespace client
         namespace x3 = boost::spirit::x3;
         namespace ascii = boost::spirit::x3::ascii;
 
-        using x3::int_;
-        using x3::lit;
-        using x3::double_;
-        using x3::lexeme;
-        using ascii::char_;
-
         x3::rule<class employee, ast::employee> const employee = "employee";
 
-        auto const quoted_string = lexeme['"' >> +(char_ - '"') >> '"'];
-
-        auto const employee_def =
-            lit("employee")
-            >> '{'
-            >>  int_ >> ','
-            >>  quoted_string >> ','
-            >>  quoted_string >> ','
-            >>  double_
-            >>  '}'
-            ;
+        auto const employee_def = employee_record([](auto const& p) { return p; });
 
         BOOST_SPIRIT_DEFINE(employee)
     }
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <boost/spirit/home/x3.hpp>
+
+namespace client
+{
+    ///////////////////////////////////////////////////////////////////////////////
+    //  The employee grammar, shared by the employee rule (employee_def.hpp)
+    //  and the bulk parser (employee_bulk.cpp)
+    ///////////////////////////////////////////////////////////////////////////////
+    namespace parser
+    {
+        namespace x3 = boost::spirit::x3;
+        namespace ascii = boost::spirit::x3::ascii;
+
+        using x3::int_;
+        using x3::lit;
+        using x3::double_;
+        using x3::lexeme;
+        using ascii::char_;
+
+        // The characters of a quoted string are parsed by name(p): p itself
+        // gives a std::string, raw[p] a range of the input (as the bulk
+        // parser of employee_bulk.cpp reads names)
+        template <typename Name>
+        auto quoted_string(Name const& name)
+        {
+            return lexeme['"' >> name(+(char_ - '"')) >> '"'];
+        }
+
+        template <typename Name>
+        auto employee_record(Name const& name)
+        {
+            return
+                lit("employee")
+                >> '{'
+                >>  int_ >> ','
+                >>  quoted_string(name) >> ','
+                >>  quoted_string(name) >> ','
+                >>  double_
+                >>  '}'
+                ;
+        }
+    }
+}
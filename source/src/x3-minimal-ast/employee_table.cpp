@@ -0,0 +1,104 @@
+#include "employee_table.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace client
+{
+    ast::employee employee_table::operator[](std::size_t i) const
+    {
+        return {ages_[i], std::string(forename(i)), std::string(surname(i)),
+                salaries_[i]};
+    }
+
+    void employee_table::reserve(std::size_t employees, std::size_t name_bytes)
+    {
+        ages_.reserve(employees);
+        salaries_.reserve(employees);
+        offsets_.reserve(2 * employees + 1);
+        arena_.reserve(name_bytes);
+    }
+
+    void employee_table::push_back(int age, std::string_view forename,
+                                   std::string_view surname, double salary)
+    {
+        ages_.push_back(age);
+        salaries_.push_back(salary);
+        arena_.append(forename);
+        offsets_.push_back(arena_.size());
+        arena_.append(surname);
+        offsets_.push_back(arena_.size());
+    }
+
+    void employee_table::append(employee_table&& other)
+    {
+        // Take over the storage of other, unless this one was reserved
+        if (empty() && ages_.capacity() == 0)
+        {
+            *this = std::move(other);
+            other = employee_table();
+            return;
+        }
+
+        ages_.insert(ages_.end(), other.ages_.begin(), other.ages_.end());
+        salaries_.insert(salaries_.end(), other.salaries_.begin(), other.salaries_.end());
+        std::size_t const base = arena_.size();
+        arena_ += other.arena_;
+        offsets_.reserve(offsets_.size() + other.offsets_.size() - 1);
+        for (auto o = other.offsets_.begin() + 1; o != other.offsets_.end(); ++o)
+            offsets_.push_back(base + *o);
+        other = employee_table();
+    }
+
+    employee_table employee_table::join(std::vector<employee_table>&& parts,
+                                        unsigned threads)
+    {
+        // Where every part starts in the joined columns and arena
+        std::vector<std::size_t> rows{0};
+        std::vector<std::size_t> bytes{0};
+        for (auto const& part : parts)
+        {
+            rows.push_back(rows.back() + part.size());
+            bytes.push_back(bytes.back() + part.arena_.size());
+        }
+
+        employee_table result;
+        result.ages_.resize(rows.back());
+        result.salaries_.resize(rows.back());
+        result.arena_.resize(bytes.back());
+        result.offsets_.resize(2 * rows.back() + 1);
+
+        std::atomic<std::size_t> next{0};
+        auto const copy = [&] {
+            for (std::size_t i = next++; i < parts.size(); i = next++)
+            {
+                employee_table& part = parts[i];
+                auto const row = static_cast<std::ptrdiff_t>(rows[i]);
+                std::copy(part.ages_.begin(), part.ages_.end(),
+                          result.ages_.begin() + row);
+                std::copy(part.salaries_.begin(), part.salaries_.end(),
+                          result.salaries_.begin() + row);
+                std::copy(part.arena_.begin(), part.arena_.end(),
+                          result.arena_.begin() + static_cast<std::ptrdiff_t>(bytes[i]));
+                // The first offset of a part is the last of the one before,
+                // which that part's thread writes, and result.offsets_[0] is 0
+                auto out = result.offsets_.begin() + 2 * row + 1;
+                auto const& offsets = part.offsets_;
+                for (auto o = offsets.begin() + 1; o != offsets.end(); ++o)
+                    *out++ = bytes[i] + *o;
+                part = employee_table();
+            }
+        };
+
+        threads = std::max(1u, std::min(threads, static_cast<unsigned>(parts.size())));
+        std::vector<std::thread> pool;
+        for (unsigned t = 1; t < threads; ++t)
+            pool.emplace_back(copy);
+        copy();
+        for (auto& worker : pool)
+            worker.join();
+        parts.clear();
+        return result;
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "ast.hpp"
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace client
+{
+    ///////////////////////////////////////////////////////////////////////////
+    //  Employees stored column by column
+    //
+    //  Ages and salaries are plain arrays. Forenames and surnames share one
+    //  string arena: the names of employee i are the ranges between
+    //  consecutive offsets, forename at 2i and surname at 2i + 1. Appending
+    //  an employee allocates nothing once the table is reserved.
+    ///////////////////////////////////////////////////////////////////////////
+    class employee_table
+    {
+    public:
+        employee_table() : offsets_{0} {}
+
+        std::size_t size() const { return ages_.size(); }
+        bool empty() const { return ages_.empty(); }
+
+        int age(std::size_t i) const { return ages_[i]; }
+        double salary(std::size_t i) const { return salaries_[i]; }
+        std::string_view forename(std::size_t i) const { return name(2 * i); }
+        std::string_view surname(std::size_t i) const { return name(2 * i + 1); }
+
+        std::vector<int> const& ages() const { return ages_; }
+        std::vector<double> const& salaries() const { return salaries_; }
+        std::string const& arena() const { return arena_; }
+
+        // Employee i with owned strings, as the employee rule produces it
+        ast::employee operator[](std::size_t i) const;
+
+        void reserve(std::size_t employees, std::size_t name_bytes);
+        void push_back(int age, std::string_view forename, std::string_view surname,
+                       double salary);
+
+        // Moves the employees of other to the end of this table
+        void append(employee_table&& other);
+
+        // The employees of all parts, in order. Each part is copied into
+        // place by one of up to `threads` threads, so that merging the
+        // results of a parallel parse does not become its serial tail.
+        static employee_table join(std::vector<employee_table>&& parts,
+                                   unsigned threads = 1);
+
+    private:
+        std::string_view name(std::size_t k) const
+        {
+            return {arena_.data() + offsets_[k], offsets_[k + 1] - offsets_[k]};
+        }
+
+        std::vector<int> ages_;
+        std::vector<double> salaries_;
+        std::string arena_;
+        std::vector<std::size_t> offsets_; // 2 * size() + 1 entries
+    };
+}
@@ -0,0 +1,158 @@
+// Multi-threaded ingestion of an employee file into an employee_table.
+//
+//   x3-minimal-ast.ingest file [threads]
+//
+// The file holds one employee record per line, as main.cpp reads them. It
+// is memory-mapped, split at line boundaries into chunks (several per
+// thread, so that uneven chunks even out), and the chunks are parsed with
+// the employee rule by a pool of `threads` (default: all cores) workers
+// pulling from a shared counter. The chunk tables are then joined in file
+// order, again on all threads. Prints the throughput and the time taken by
+// every stage.
+#include "ast.hpp"
+#include "employee.hpp"
+#include "employee_table.hpp"
+#include "io/mapped_file.hpp"
+#include "io/split.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    struct chunk
+    {
+        client::employee_table table;
+        char const* error = nullptr; // the record that failed to parse
+    };
+
+    void parse(char const* first, char const* last, chunk& out)
+    {
+        using boost::spirit::x3::ascii::space;
+
+        // Reused for every record, so that its strings stop allocating
+        client::ast::employee emp;
+        char const* iter = first;
+        while (iter != last && std::isspace(static_cast<unsigned char>(*iter)))
+            ++iter;
+        while (iter != last)
+        {
+            char const* const start = iter;
+            emp.forename.clear();
+            emp.surname.clear();
+            if (!phrase_parse(iter, last, client::employee(), space, emp))
+            {
+                out.error = start;
+                return;
+            }
+            out.table.push_back(emp.age, emp.forename, emp.surname, emp.salary);
+        }
+    }
+
+    // The thread count argument: 0 for all cores, up to max_threads
+    constexpr unsigned long max_threads = 1024;
+
+    bool parse_threads(char const* text, unsigned& threads)
+    {
+        if (!std::isdigit(static_cast<unsigned char>(*text)))
+            return false;
+        char* end = nullptr;
+        errno = 0;
+        unsigned long const value = std::strtoul(text, &end, 10);
+        if (errno != 0 || *end != '\0' || value > max_threads)
+            return false;
+        threads = static_cast<unsigned>(value);
+        return true;
+    }
+
+    using clock = std::chrono::steady_clock;
+
+    double seconds_since(clock::time_point& start)
+    {
+        auto const now = clock::now();
+        std::chrono::duration<double> const elapsed = now - start;
+        start = now;
+        return elapsed.count();
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::fprintf(stderr, "usage: %s file [threads]\n", argv[0]);
+        return 2;
+    }
+    unsigned threads = 0;
+    if (argc > 2 && !parse_threads(argv[2], threads))
+    {
+        std::fprintf(stderr, "%s: threads must be a number from 0 to %lu\n", argv[0],
+                     max_threads);
+        return 2;
+    }
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+
+    auto const total_start = clock::now();
+    auto start = total_start;
+
+    io::mapped_file const file(argv[1]);
+    double const map_time = seconds_since(start);
+
+    auto const cuts = io::split_lines(file.begin(), file.end(), std::size_t{8} * threads);
+    std::size_t const chunks = cuts.size() - 1;
+    double const split_time = seconds_since(start);
+
+    std::vector<chunk> results(chunks);
+    {
+        std::atomic<std::size_t> next{0};
+        auto const work = [&] {
+            for (std::size_t i = next++; i < chunks; i = next++)
+                parse(cuts[i], cuts[i + 1], results[i]);
+        };
+
+        std::vector<std::thread> pool;
+        pool.reserve(threads);
+        for (unsigned t = 0; t < threads; ++t)
+            pool.emplace_back(work);
+        for (auto& worker : pool)
+            worker.join();
+    }
+    double const parse_time = seconds_since(start);
+
+    for (auto const& r : results)
+    {
+        if (r.error != nullptr)
+        {
+            auto const offset = static_cast<std::size_t>(r.error - file.begin());
+            std::fprintf(stderr, "%s: malformed employee record at byte %zu\n", argv[1],
+                         offset);
+            return 1;
+        }
+    }
+
+    std::vector<client::employee_table> tables;
+    tables.reserve(chunks);
+    for (auto& r : results)
+        tables.push_back(std::move(r.table));
+    auto const table = client::employee_table::join(std::move(tables), threads);
+    double const merge_time = seconds_since(start);
+
+    std::chrono::duration<double> const total = clock::now() - total_start;
+    double const mb = static_cast<double>(file.size()) / (1024.0 * 1024.0);
+    std::printf("%zu records, %.1f MB, %u threads, %zu chunks\n", table.size(), mb,
+                threads, chunks);
+    std::printf("  map   %8.3f s\n  split %8.3f s\n  parse %8.3f s\n  merge %8.3f s\n",
+                map_time, split_time, parse_time, merge_time);
+    std::printf("  total %8.3f s  %.1f MB/s  %.0f records/s\n", total.count(),
+                mb / total.count(), static_cast<double>(table.size()) / total.count());
+    return 0;
+}
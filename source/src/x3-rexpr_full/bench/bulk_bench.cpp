@@ -0,0 +1,90 @@
+// Throughput of bulk rexpr parsing on a synthetic config dump.
+//
+//   rexpr.bench [megabytes] [path]
+//
+// Writes `megabytes` (default 256) of generated top-level rexprs to `path`
+// (default rexpr_bench.input, removed afterwards), then parses it from an
+// mmap-ed region and, for comparison, after copying it into a std::string.
+// The parser lives in the rexpr library, so configure with
+// -DCMAKE_BUILD_TYPE=Release for meaningful numbers.
+#include "rexpr/bulk.hpp"
+#include "rexpr/mapped_file.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+
+namespace
+{
+void write_record(std::ostream& out, std::size_t n)
+{
+    out << "{\n"
+        << "    \"name\" = \"service-" << n << "\"\n"
+        << "    \"host\" = \"10.0." << (n >> 8) % 256 << '.' << n % 256 << "\"\n"
+        << "    \"limits\" = {\n"
+        << "        \"cpu\" = \"" << n % 16 + 1 << "\"\n"
+        << "        \"memory\" = \"" << (n % 64 + 1) * 128 << " MB\"\n"
+        << "    }\n"
+        << "    \"labels\" = {\n"
+        << "        \"team\" = \"team-" << n % 97 << "\"\n"
+        << "        \"tier\" = \"" << (n % 3 == 0 ? "frontend" : "backend") << "\"\n"
+        << "    }\n"
+        << "}\n";
+}
+
+std::size_t generate(std::string const& path, std::size_t bytes)
+{
+    std::ofstream out(path, std::ios::binary);
+    std::size_t records = 0;
+    while (static_cast<std::size_t>(out.tellp()) < bytes)
+        write_record(out, records++);
+    return records;
+}
+
+template <typename F>
+void run(char const* label, std::size_t bytes, F&& parse)
+{
+    auto const start = std::chrono::steady_clock::now();
+    auto const result = parse();
+    std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now() - start;
+
+    double const mb = static_cast<double>(bytes) / (1024.0 * 1024.0);
+    std::printf("%-16s %10zu rexprs %9.1f MB %8.3f s %8.1f MB/s%s\n", label, result.count, mb,
+                elapsed.count(), mb / elapsed.count(), result.ok ? "" : "  (FAILED)");
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::size_t const megabytes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 256;
+    std::string const path = argc > 2 ? argv[2] : "rexpr_bench.input";
+
+    std::size_t const records = generate(path, megabytes * 1024 * 1024);
+    std::printf("generated %zu rexprs in %s\n", records, path.c_str());
+
+    std::size_t entries = 0;
+    auto const count = [&](rexpr::ast::rexpr&& r) { entries += r.entries.size(); };
+
+    std::size_t size = 0;
+    {
+        rexpr::mapped_file const file(path);
+        size = file.size();
+        run("mmap", size, [&] {
+            return rexpr::parse_all(file.begin(), file.end(), count, std::cerr, path);
+        });
+    }
+    run("read + copy", size, [&] {
+        std::ifstream in(path, std::ios::binary);
+        std::string const text{std::istreambuf_iterator<char>(in),
+                               std::istreambuf_iterator<char>()};
+        return rexpr::parse_all(text.data(), text.data() + text.size(), count, std::cerr,
+                                path);
+    });
+
+    std::remove(path.c_str());
+    std::printf("%zu top-level entries\n", entries);
+}
@@ -0,0 +1,86 @@
+// Owning AST versus flat document on one large rexpr.
+//
+//   rexpr.document.bench [megabytes]
+//
+// Generates a single rexpr of about `megabytes` (default 64) MB, with one
+// nested entry per service, and times parsing it into ast::rexpr (std::map,
+// std::string), into flat::document (sorted vectors, string_view) and into
+// nothing at all, counting keys through the event parser.
+// Configure with -DCMAKE_BUILD_TYPE=Release for meaningful numbers.
+#include "rexpr/bulk.hpp"
+#include "rexpr/document.hpp"
+#include "rexpr/events.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+namespace
+{
+class key_counter : public rexpr::event_handler
+{
+public:
+    void key(std::string_view) override { ++keys; }
+
+    std::size_t keys = 0;
+};
+
+std::string generate(std::size_t bytes)
+{
+    std::ostringstream out;
+    out << "{\n";
+    for (std::size_t n = 0; static_cast<std::size_t>(out.tellp()) < bytes; ++n)
+    {
+        out << "    \"service-" << n << "\" = {\n"
+            << "        \"host\" = \"10.0." << (n >> 8) % 256 << '.' << n % 256 << "\"\n"
+            << "        \"cpu\" = \"" << n % 16 + 1 << "\"\n"
+            << "        \"memory\" = \"" << (n % 64 + 1) * 128 << " MB\"\n"
+            << "        \"team\" = \"team-" << n % 97 << "\"\n"
+            << "    }\n";
+    }
+    out << "}\n";
+    return out.str();
+}
+
+template <typename F>
+void run(char const* label, std::size_t bytes, F&& parse)
+{
+    auto const start = std::chrono::steady_clock::now();
+    bool const ok = parse();
+    std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now() - start;
+
+    double const mb = static_cast<double>(bytes) / (1024.0 * 1024.0);
+    std::printf("%-16s %9.1f MB %8.3f s %8.1f MB/s%s\n", label, mb, elapsed.count(),
+                mb / elapsed.count(), ok ? "" : "  (FAILED)");
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::size_t const megabytes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 64;
+    std::string const text = generate(megabytes * 1024 * 1024);
+
+    run("ast::rexpr", text.size(), [&] {
+        std::size_t entries = 0;
+        auto const result =
+            rexpr::parse_all(text.data(), text.data() + text.size(),
+                             [&](rexpr::ast::rexpr&& r) { entries += r.entries.size(); },
+                             std::cerr);
+        return result.ok && entries != 0;
+    });
+
+    run("flat::document", text.size(), [&] {
+        auto const doc = rexpr::flat::parse_document(std::string_view(text), std::cerr);
+        return doc && doc->entry_count() != 0;
+    });
+
+    run("events", text.size(), [&] {
+        key_counter counter;
+        return rexpr::parse_events(text.data(), text.data() + text.size(), counter,
+                                   std::cerr) &&
+               counter.keys != 0;
+    });
+}
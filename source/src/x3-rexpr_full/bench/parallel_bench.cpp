@@ -0,0 +1,59 @@
+// Scaling of parse_parallel with the number of threads.
+//
+//   rexpr.parallel.bench [megabytes]
+//
+// Generates one rexpr of about `megabytes` (default 1024) MB and parses it
+// with 1, 2, 4, ... threads, up to the number of cores. Configure with
+// -DCMAKE_BUILD_TYPE=Release for meaningful numbers.
+#include "rexpr/parallel.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+namespace
+{
+std::string generate(std::size_t bytes)
+{
+    std::string text = "{\n";
+    for (std::size_t n = 0; text.size() < bytes; ++n)
+    {
+        auto const id = std::to_string(n);
+        text += "    \"service-" + id + "\" = {\n";
+        text += "        \"host\" = \"10.0." + std::to_string((n >> 8) % 256) + '.' +
+                std::to_string(n % 256) + "\"\n";
+        text += "        \"memory\" = \"" + std::to_string((n % 64 + 1) * 128) + " MB\"\n";
+        text += "        \"team\" = \"team-" + std::to_string(n % 97) + "\"\n";
+        text += "    }\n";
+    }
+    text += "}\n";
+    return text;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::size_t const megabytes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1024;
+    std::string const text = generate(megabytes * 1024 * 1024);
+    double const mb = static_cast<double>(text.size()) / (1024.0 * 1024.0);
+
+    auto const start = std::chrono::steady_clock::now();
+    auto const entries = rexpr::scan_entries(text.data(), text.data() + text.size());
+    std::chrono::duration<double> const scan = std::chrono::steady_clock::now() - start;
+    std::printf("scan        %9.1f MB %8.3f s %8.1f MB/s  %zu entries\n", mb, scan.count(),
+                mb / scan.count(), entries.size() - 1);
+
+    unsigned const cores = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned threads = 1; threads <= cores; threads *= 2)
+    {
+        auto const begin = std::chrono::steady_clock::now();
+        auto const ast = rexpr::parse_parallel(text.data(), text.data() + text.size(),
+                                               std::cerr, threads);
+        std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now() - begin;
+        std::printf("%2u threads  %9.1f MB %8.3f s %8.1f MB/s%s\n", threads, mb,
+                    elapsed.count(), mb / elapsed.count(), ast ? "" : "  (FAILED)");
+    }
+}
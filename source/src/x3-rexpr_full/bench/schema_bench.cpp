@@ -0,0 +1,105 @@
+// Typed extraction of a few fields versus building the whole AST.
+//
+//   rexpr.schema.bench [megabytes]
+//
+// Generates a rexpr of about `megabytes` (default 64) MB in which only a
+// handful of fields are of interest, and reads them through the schema API
+// and through parse_all plus a walk of ast::rexpr. Configure with
+// -DCMAKE_BUILD_TYPE=Release for meaningful numbers.
+#include "rexpr/bulk.hpp"
+#include "rexpr/schema.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+namespace schema_bench
+{
+struct owner
+{
+    std::string team;
+    int id = 0;
+};
+
+struct config
+{
+    int version = 0;
+    std::string name;
+    owner owned_by;
+};
+} // namespace schema_bench
+
+BOOST_FUSION_ADAPT_STRUCT(schema_bench::owner, team, id)
+BOOST_FUSION_ADAPT_STRUCT(schema_bench::config, version, name, owned_by)
+
+namespace
+{
+std::string generate(std::size_t bytes)
+{
+    std::string text = "{\n    \"version\" = \"3\"\n    \"name\" = \"fleet\"\n";
+    text += "    \"services\" = {\n";
+    for (std::size_t n = 0; text.size() < bytes; ++n)
+    {
+        text += "        \"service-" + std::to_string(n) + "\" = {\n";
+        text += "            \"host\" = \"10.0." + std::to_string(n % 256) + ".1\"\n";
+        text += "            \"memory\" = \"" + std::to_string((n % 64 + 1) * 128) + "\"\n";
+        text += "        }\n";
+    }
+    text += "    }\n    \"owned_by\" = { \"team\" = \"core\" \"id\" = \"42\" }\n}\n";
+    return text;
+}
+
+std::string const& text_of(rexpr::ast::rexpr const& r, std::string const& key)
+{
+    return boost::get<std::string>(r.entries.at(key));
+}
+
+rexpr::ast::rexpr const& child_of(rexpr::ast::rexpr const& r, std::string const& key)
+{
+    using child = rexpr::ast::x3::forward_ast<rexpr::ast::rexpr>;
+    return boost::get<child>(r.entries.at(key)).get();
+}
+
+template <typename F>
+void run(char const* label, std::size_t bytes, F&& extract)
+{
+    auto const start = std::chrono::steady_clock::now();
+    schema_bench::config const c = extract();
+    std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now() - start;
+
+    double const mb = static_cast<double>(bytes) / (1024.0 * 1024.0);
+    std::printf("%-10s %9.1f MB %8.3f s %8.1f MB/s  (%d %s %s %d)\n", label, mb,
+                elapsed.count(), mb / elapsed.count(), c.version, c.name.c_str(),
+                c.owned_by.team.c_str(), c.owned_by.id);
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::size_t const megabytes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 64;
+    std::string const text = generate(megabytes * 1024 * 1024);
+    char const* const first = text.data();
+    char const* const last = first + text.size();
+
+    run("schema", text.size(), [&] {
+        schema_bench::config c;
+        rexpr::schema::extract(first, last, c, std::cerr);
+        return c;
+    });
+
+    run("ast", text.size(), [&] {
+        schema_bench::config c;
+        rexpr::parse_all(first, last,
+                         [&](rexpr::ast::rexpr&& r) {
+                             c.version = std::stoi(text_of(r, "version"));
+                             c.name = text_of(r, "name");
+                             auto const& o = child_of(r, "owned_by");
+                             c.owned_by.team = text_of(o, "team");
+                             c.owned_by.id = std::stoi(text_of(o, "id"));
+                         },
+                         std::cerr);
+        return c;
+    });
+}
@@ -0,0 +1,90 @@
+// Output throughput of rexpr_printer versus serializer.
+//
+//   rexpr.serializer.bench [megabytes] [path]
+//
+// Parses a generated rexpr of about `megabytes` (default 64) MB and writes
+// it back out to `path` (default rexpr_bench.output, removed afterwards)
+// with the printer through std::ofstream, and with the serializer in both
+// layouts through a file descriptor. Configure with
+// -DCMAKE_BUILD_TYPE=Release for meaningful numbers.
+#include "rexpr/bulk.hpp"
+#include "rexpr/printer.hpp"
+#include "rexpr/serializer.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace
+{
+std::string generate(std::size_t bytes)
+{
+    std::string text = "{\n";
+    for (std::size_t n = 0; text.size() < bytes; ++n)
+    {
+        text += "    \"service-" + std::to_string(n) + "\" = {\n";
+        text += "        \"host\" = \"10.0." + std::to_string((n >> 8) % 256) + '.' +
+                std::to_string(n % 256) + "\"\n";
+        text += "        \"limits\" = { \"memory\" = \"" + std::to_string((n % 64 + 1) * 128) +
+                " MB\" }\n";
+        text += "    }\n";
+    }
+    text += "}\n";
+    return text;
+}
+
+template <typename F>
+void run(char const* label, std::string const& path, F&& write)
+{
+    auto const start = std::chrono::steady_clock::now();
+    write();
+    std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now() - start;
+
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    double const mb = static_cast<double>(in.tellg()) / (1024.0 * 1024.0);
+    std::printf("%-20s %9.1f MB %8.3f s %8.1f MB/s\n", label, mb, elapsed.count(),
+                mb / elapsed.count());
+}
+
+template <typename F>
+void run_fd(char const* label, std::string const& path, F&& write)
+{
+    run(label, path, [&] {
+        int const fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        write(fd);
+        ::close(fd);
+    });
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::size_t const megabytes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 64;
+    std::string const path = argc > 2 ? argv[2] : "rexpr_bench.output";
+
+    std::string const text = generate(megabytes * 1024 * 1024);
+    rexpr::ast::rexpr ast;
+    rexpr::parse_all(text.data(), text.data() + text.size(),
+                     [&](rexpr::ast::rexpr&& r) { ast = std::move(r); }, std::cerr);
+
+    run("printer", path, [&] {
+        std::ofstream out(path, std::ios::binary);
+        rexpr::ast::rexpr_printer{out}(ast);
+    });
+    run_fd("serializer pretty", path, [&](int fd) {
+        rexpr::serializer s(fd, rexpr::layout::pretty);
+        s.write(ast);
+    });
+    run_fd("serializer compact", path, [&](int fd) {
+        rexpr::serializer s(fd, rexpr::layout::compact);
+        s.write(ast);
+    });
+
+    std::remove(path.c_str());
+}
@@ -0,0 +1,113 @@
+// Typed values versus numbers kept as quoted text.
+//
+//   rexpr.typed.bench [megabytes] [passes]
+//
+// Generates the same services (about `megabytes`, default 16, MB of them as
+// text) twice, once with every number and boolean quoted and once with
+// native values and arrays, parses both into ASTs and
+// reports the memory they take and the time to look up and convert every
+// setting `passes` (default 10) times. Configure with
+// -DCMAKE_BUILD_TYPE=Release for meaningful numbers.
+#include "rexpr/bulk.hpp"
+
+#include "alloc_tracking.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+std::string generate(std::size_t services, bool typed)
+{
+    auto const quote = [typed](std::string const& v) {
+        return typed ? v : '"' + v + '"';
+    };
+
+    std::string text;
+    for (std::size_t n = 0; n < services; ++n)
+    {
+        text += "{\n    \"name\" = \"service-" + std::to_string(n) + "\"\n";
+        text += "    \"memory\" = " + quote(std::to_string((n % 64 + 1) * 128)) + "\n";
+        text += "    \"load\" = " + quote(std::to_string(n % 100) + ".25") + "\n";
+        text += "    \"enabled\" = " + quote(n % 3 ? "true" : "false") + "\n";
+        if (typed)
+            text += "    \"ports\" = [80 443 " + std::to_string(8000 + n % 1000) + "]\n";
+        else
+            text += "    \"ports\" = { \"0\" = \"80\" \"1\" = \"443\" \"2\" = \"" +
+                    std::to_string(8000 + n % 1000) + "\" }\n";
+        text += "}\n";
+    }
+    return text;
+}
+
+namespace ast = rexpr::ast;
+using ast::x3::forward_ast;
+
+double convert_text(ast::rexpr const& r)
+{
+    auto const& e = r.entries;
+    double sum = static_cast<double>(std::stoll(boost::get<std::string>(e.at("memory"))));
+    sum += std::stod(boost::get<std::string>(e.at("load")));
+    sum += boost::get<std::string>(e.at("enabled")) == "true";
+    auto const& ports = boost::get<forward_ast<ast::rexpr>>(e.at("ports")).get();
+    for (auto const& port : ports.entries)
+        sum += static_cast<double>(std::stoll(boost::get<std::string>(port.second)));
+    return sum;
+}
+
+double convert_typed(ast::rexpr const& r)
+{
+    auto const& e = r.entries;
+    double sum = static_cast<double>(boost::get<std::int64_t>(e.at("memory")));
+    sum += boost::get<double>(e.at("load"));
+    sum += boost::get<bool>(e.at("enabled"));
+    auto const& ports = boost::get<forward_ast<ast::rexpr_array>>(e.at("ports")).get();
+    for (auto const& port : ports.elements)
+        sum += static_cast<double>(boost::get<std::int64_t>(port));
+    return sum;
+}
+
+using seconds = std::chrono::duration<double>;
+
+void run(char const* label, std::string const& text, unsigned passes,
+         double (*convert)(ast::rexpr const&))
+{
+    std::vector<ast::rexpr> asts;
+    auto const start = std::chrono::steady_clock::now();
+    std::size_t const bytes = alloc_tracking::measure([&] {
+        rexpr::parse_all(text.data(), text.data() + text.size(),
+                         [&](ast::rexpr&& r) { asts.push_back(std::move(r)); }, std::cerr);
+    }).bytes;
+    seconds const parse = std::chrono::steady_clock::now() - start;
+
+    auto const lookup_start = std::chrono::steady_clock::now();
+    double sum = 0;
+    for (unsigned pass = 0; pass < passes; ++pass)
+        for (auto const& r : asts)
+            sum += convert(r);
+    seconds const lookup = std::chrono::steady_clock::now() - lookup_start;
+
+    double const mb = 1024.0 * 1024.0;
+    std::printf("%-6s %8.1f MB text %8.1f MB allocated  parse %7.3f s  "
+                "lookup+convert %7.3f s  (%g)\n",
+                label, static_cast<double>(text.size()) / mb,
+                static_cast<double>(bytes) / mb, parse.count(), lookup.count(), sum);
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::size_t const megabytes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 16;
+    unsigned const passes = argc > 2 ? static_cast<unsigned>(std::atoi(argv[2])) : 10;
+
+    // A service takes about 160 bytes of quoted text
+    std::size_t const services = megabytes * 1024 * 1024 / 160;
+
+    run("text", generate(services, false), passes, convert_text);
+    run("typed", generate(services, true), passes, convert_typed);
+}
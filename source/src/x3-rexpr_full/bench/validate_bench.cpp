@@ -0,0 +1,88 @@
+// Validation of many small messages, most of them malformed.
+//
+//   rexpr.validate.bench [messages] [malformed percent]
+//
+// Generates `messages` (default 1000000) small rexprs of which `malformed
+// percent` (default 75) carry an error, and checks each one by parsing it
+// into an AST and with the event parser, both reporting errors as text
+// (to a stream that discards them), and with validate, which only records
+// them. Configure with -DCMAKE_BUILD_TYPE=Release for meaningful numbers.
+#include "rexpr/bulk.hpp"
+#include "rexpr/events.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace
+{
+class null_buffer : public std::streambuf
+{
+protected:
+    int overflow(int c) override { return c; }
+};
+
+std::vector<std::string> generate(std::size_t messages, std::size_t malformed)
+{
+    char const* const errors[] = {
+        R"({ "id" = 7 "name" "x" })",         // missing '='
+        R"({ "id" = 7 "tags" = [1 2 })",      // missing ']'
+        R"({ "id" = 7 "name" = $ })",         // missing value
+        R"({ "id" = 7 "name" = "x" } junk)",  // trailing input
+    };
+
+    std::vector<std::string> result;
+    result.reserve(messages);
+    for (std::size_t n = 0; n < messages; ++n)
+    {
+        if (n % 100 < malformed)
+            result.push_back(errors[n % 4]);
+        else
+            result.push_back(R"({ "id" = )" + std::to_string(n) +
+                             R"( "name" = "x" "tags" = [1 2] })");
+    }
+    return result;
+}
+
+template <typename F>
+void run(char const* label, std::vector<std::string> const& messages, F&& check)
+{
+    auto const start = std::chrono::steady_clock::now();
+    std::size_t valid = 0;
+    for (auto const& m : messages)
+        valid += check(m.data(), m.data() + m.size());
+    std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now() - start;
+
+    double const rate = static_cast<double>(messages.size()) / elapsed.count();
+    std::printf("%-8s %8.3f s %10.0f messages/s  (%zu valid)\n", label, elapsed.count(), rate,
+                valid);
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::size_t const count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    std::size_t const malformed = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 75;
+    auto const messages = generate(count, malformed);
+
+    null_buffer discard;
+    std::ostream err(&discard);
+
+    run("ast", messages, [&](char const* first, char const* last) {
+        return rexpr::parse_all(first, last, [](rexpr::ast::rexpr&&) {}, err).ok;
+    });
+
+    run("events", messages, [&](char const* first, char const* last) {
+        rexpr::event_handler ignore;
+        return rexpr::parse_events(first, last, ignore, err);
+    });
+
+    run("validate", messages, [&](char const* first, char const* last) {
+        rexpr::parse_error error;
+        return rexpr::validate(first, last, error);
+    });
+}
@@ -9,8 +9,10 @@
 #include <boost/spirit/home/x3/support/ast/position_tagged.hpp>
 #include <boost/spirit/home/x3/support/ast/variant.hpp>
 
+#include <cstdint>
 #include <map>
 #include <string>
+#include <vector>
 
 namespace rexpr::ast
 {
@@ -20,8 +22,11 @@ namespace rexpr::ast
 namespace x3 = boost::spirit::x3;
 
 struct rexpr;
+struct rexpr_array;
 
-struct rexpr_value : x3::variant<std::string, x3::forward_ast<rexpr>>
+struct rexpr_value
+    : x3::variant<std::string, std::int64_t, double, bool, x3::forward_ast<rexpr>,
+                  x3::forward_ast<rexpr_array>>
 {
     using base_type::base_type;
     using base_type::operator=;
@@ -39,4 +44,9 @@ struct rexpr : x3::position_tagged
     rexpr_map entries;
 };
 
+struct rexpr_array : x3::position_tagged
+{
+    std::vector<rexpr_value> elements;
+};
+
 } // namespace rexpr::ast
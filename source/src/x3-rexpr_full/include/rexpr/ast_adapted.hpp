@@ -19,4 +19,8 @@ BOOST_FUSION_ADAPT_STRUCT(rexpr::ast::rexpr,
     entries
 )
 
+BOOST_FUSION_ADAPT_STRUCT(rexpr::ast::rexpr_array,
+    elements
+)
+
 #endif
@@ -0,0 +1,144 @@
+#pragma once
+
+#include "ast.hpp"
+#include "mapped_file.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace rexpr::binary
+{
+///////////////////////////////////////////////////////////////////////////
+//  A binary rexpr format that is navigated in place
+//
+//  Layout (native byte order, 32-bit offsets from the start of the data):
+//
+//      header:  "REXB", version, byte-order mark, offset of the root node
+//      node:    entry count, then the entries sorted by key
+//      entry:   key offset, key size, value offset, value size
+//      array:   element count, then a value offset and size per element
+//
+//  The value size of a string is its length; strings are stored unquoted
+//  and unterminated. Sizes from the top of the range are tags instead:
+//  nested_rexpr and nested_array point at a node or array, integer and real
+//  at eight bytes of data, and boolean keeps its value in the offset.
+//
+//  Nodes, arrays and values know the size of the data they point into, and
+//  every offset and size read from it is checked against that size before
+//  it is followed: truncated or corrupt data throws std::runtime_error
+//  instead of being read out of bounds. A nested node or array must lie
+//  after the table that points at it, so corrupt offsets cannot form cycles.
+///////////////////////////////////////////////////////////////////////////
+std::uint32_t const version = 2;
+std::uint32_t const nested_rexpr = ~std::uint32_t(0);
+std::uint32_t const nested_array = nested_rexpr - 1;
+std::uint32_t const integer = nested_rexpr - 2;
+std::uint32_t const real = nested_rexpr - 3;
+std::uint32_t const boolean = nested_rexpr - 4;
+
+// Throws std::length_error if the result would exceed 4 GB
+std::string compile(ast::rexpr const& r);
+
+class node;
+class array;
+
+class value
+{
+public:
+    bool is_string() const { return size_ < boolean; }
+    bool is_integer() const { return size_ == integer; }
+    bool is_real() const { return size_ == real; }
+    bool is_boolean() const { return size_ == boolean; }
+    bool is_rexpr() const { return size_ == nested_rexpr; }
+    bool is_array() const { return size_ == nested_array; }
+
+    std::string_view text() const;
+    std::int64_t as_integer() const;
+    double as_real() const;
+    bool as_boolean() const { return offset_ != 0; }
+    node rexpr() const;
+    binary::array array() const;
+
+private:
+    friend class node;
+    friend class binary::array;
+    value(char const* data, std::size_t bytes, std::uint32_t offset, std::uint32_t size)
+        : data_(data), bytes_(bytes), offset_(offset), size_(size)
+    {
+    }
+
+    char const* data_;
+    std::size_t bytes_; // of data_
+    std::uint32_t offset_;
+    std::uint32_t size_;
+};
+
+class array
+{
+public:
+    array(char const* data, std::size_t bytes, std::uint32_t offset)
+        : data_(data), bytes_(bytes), offset_(offset)
+    {
+    }
+
+    std::size_t size() const;
+    // Throws std::out_of_range if i >= size()
+    value at(std::size_t i) const;
+
+private:
+    char const* data_;
+    std::size_t bytes_;
+    std::uint32_t offset_;
+};
+
+class node
+{
+public:
+    node(char const* data, std::size_t bytes, std::uint32_t offset)
+        : data_(data), bytes_(bytes), offset_(offset)
+    {
+    }
+
+    std::size_t size() const;
+    // Both throw std::out_of_range if i >= size()
+    std::string_view key(std::size_t i) const;
+    value at(std::size_t i) const;
+
+    // Binary search by key
+    std::optional<value> find(std::string_view key) const;
+
+private:
+    std::uint32_t field(std::size_t i, std::size_t f) const;
+
+    char const* data_;
+    std::size_t bytes_;
+    std::uint32_t offset_;
+};
+
+// Checks the header and returns the root; throws std::runtime_error if the
+// bytes are not in this format. Nothing else is read up front; the rest is
+// checked as it is reached.
+node root(std::string_view data);
+
+// Rebuilds the owning AST, e.g. to print it
+ast::rexpr to_ast(node const& n);
+
+///////////////////////////////////////////////////////////////////////////
+//  A compiled file, mapped read-only
+///////////////////////////////////////////////////////////////////////////
+class file
+{
+public:
+    explicit file(std::string const& path);
+
+    node root() const { return root_; }
+
+private:
+    std::unique_ptr<mapped_file const> mapping_;
+    node root_;
+};
+} // namespace rexpr::binary
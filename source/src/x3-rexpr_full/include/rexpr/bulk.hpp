@@ -0,0 +1,31 @@
+#pragma once
+
+#include "ast.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <iosfwd>
+#include <string>
+
+namespace rexpr
+{
+///////////////////////////////////////////////////////////////////////////
+//  Bulk parsing: a buffer holding any number of top-level rexprs
+///////////////////////////////////////////////////////////////////////////
+struct bulk_result
+{
+    bool ok = true;
+    std::size_t count = 0;        // rexprs parsed successfully
+    std::size_t error_offset = 0; // where the failing rexpr starts, if !ok
+};
+
+using rexpr_callback = std::function<void(ast::rexpr&&)>;
+
+// Parses the rexprs in [first, last) one after another, straight from memory,
+// and hands each one to on_rexpr as soon as it is complete. Stops at the first
+// malformed rexpr; the error is reported to `err` in the usual format, with
+// `file` as the file name. Position annotations are kept per rexpr, so memory
+// does not grow with the number of rexprs in the buffer.
+bulk_result parse_all(char const* first, char const* last, rexpr_callback const& on_rexpr,
+                      std::ostream& err, std::string const& file = "");
+} // namespace rexpr
@@ -25,5 +25,12 @@ using error_handler_type = error_handler<iterator_type>;
 using context_type = x3::context<error_handler_tag,
                                 std::reference_wrapper<error_handler_type> const,
                                 phrase_context_type>;
+
+// The same for parsing straight from memory (e.g. an mmap-ed file)
+using pointer_iterator_type = char const*;
+using pointer_error_handler_type = error_handler<pointer_iterator_type>;
+using pointer_context_type = x3::context<error_handler_tag,
+                                        std::reference_wrapper<pointer_error_handler_type> const,
+                                        phrase_context_type>;
 }
 
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "mapped_file.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace rexpr::flat
+{
+///////////////////////////////////////////////////////////////////////////
+//  A zero-copy alternative to ast::rexpr
+//
+//  Keys and string values are views into the parsed source, and the entries
+//  of every rexpr are stored contiguously, sorted by key, in one vector per
+//  document. Nothing is allocated per string or per entry. Arrays are nodes
+//  too, whose entries have empty keys and keep their order.
+///////////////////////////////////////////////////////////////////////////
+std::uint32_t const no_child = ~std::uint32_t(0);
+
+enum class kind : std::uint8_t
+{
+    string,
+    integer,
+    real,
+    boolean,
+    rexpr,
+    array
+};
+
+struct value
+{
+    kind type = kind::string;
+    std::string_view text;          // the unquoted string
+    std::uint32_t child = no_child; // index of the nested rexpr or array
+    std::int64_t integer = 0;
+    double real = 0;
+    bool boolean = false;
+
+    bool is_rexpr() const { return type == kind::rexpr; }
+    bool is_array() const { return type == kind::array; }
+};
+
+struct entry
+{
+    std::string_view key;
+    value val;
+};
+
+struct node
+{
+    std::uint32_t first = 0; // index of the first entry
+    std::uint32_t size = 0;
+};
+
+///////////////////////////////////////////////////////////////////////////
+//  A parsed document
+//
+//  Ownership: the views stay valid for as long as the source does. A
+//  document parsed from a std::string_view borrows the caller's buffer; one
+//  parsed from a shared std::string or mapped_file keeps that buffer alive
+//  itself, so it can be moved around and outlive the caller's handle.
+///////////////////////////////////////////////////////////////////////////
+class document
+{
+public:
+    node const& root() const { return nodes_.back(); }
+    node const& child(value const& v) const { return nodes_[v.child]; }
+
+    entry const* begin(node const& n) const { return entries_.data() + n.first; }
+    entry const* end(node const& n) const { return begin(n) + n.size; }
+
+    // Binary search among the entries of n; nullptr if key is absent
+    value const* find(node const& n, std::string_view key) const;
+
+    std::string_view source() const { return source_; }
+    std::size_t node_count() const { return nodes_.size(); }
+    std::size_t entry_count() const { return entries_.size(); }
+
+private:
+    friend class document_builder;
+
+    std::string_view source_;
+    std::shared_ptr<void const> owner_;
+    std::vector<entry> entries_; // the entries of each node, nested nodes first
+    std::vector<node> nodes_;    // the root comes last
+};
+
+// Parse a single rexpr. Errors are reported to err in the same format as
+// the rexpr parser, and std::nullopt is returned.
+std::optional<document> parse_document(std::string_view source, std::ostream& err,
+                                       std::string const& file = "");
+std::optional<document> parse_document(std::shared_ptr<std::string const> source,
+                                       std::ostream& err, std::string const& file = "");
+std::optional<document> parse_document(std::shared_ptr<mapped_file const> source,
+                                       std::ostream& err, std::string const& file = "");
+
+// Prints the document in the same layout as ast::rexpr_printer
+void print(std::ostream& out, document const& doc);
+} // namespace rexpr::flat
@@ -7,12 +7,16 @@
 #if !defined(BOOST_SPIRIT_X3_REPR_ERROR_HANDLER_HPP)
 #define BOOST_SPIRIT_X3_REPR_ERROR_HANDLER_HPP
 
+#include "parse_error.hpp"
 #include "rexpr.hpp"
 
 #include <boost/spirit/home/x3/support/ast/position_tagged.hpp>
 #include <boost/spirit/home/x3/support/utility/error_reporting.hpp>
 
-#include <map>
+#include <cctype>
+#include <functional>
+#include <string>
+#include <type_traits>
 
 namespace rexpr::parser
 {
@@ -28,41 +32,64 @@ using error_handler = x3::error_handler<Iterator>;
 // tag used to get our error handler from the context
 using error_handler_tag = x3::error_handler_tag;
 
-struct error_handler_base
+// Record-only mode: with an error_recorder in the context (under
+// error_recorder_tag), errors are stored in it instead of being formatted
+// and written through the error handler.
+struct error_recorder
 {
-    error_handler_base();
+    char const* first; // start of the parsed buffer
+    parse_error error;
+    bool failed = false;
+};
+
+struct error_recorder_tag;
 
+// Rule names are looked up in the static table of parse_error.hpp, so the
+// (default constructed) rule IDs deriving from this cost nothing to create
+struct error_handler_base
+{
     template <typename Iterator, typename Exception, typename Context>
     x3::error_handler_result on_error(Iterator& first, Iterator const& last,
                                       Exception const& x, Context const& context);
-
-    std::map<std::string, std::string> id_map;
 };
 
 ////////////////////////////////////////////////////////////////////////////
 // Implementation
 ////////////////////////////////////////////////////////////////////////////
 
-inline error_handler_base::error_handler_base()
-{
-    id_map["rexpr"] = "RExpression";
-    id_map["rexpr_value"] = "Value";
-    id_map["rexpr_key_value"] = "Key value pair";
-}
-
 template <typename Iterator, typename Exception, typename Context>
 inline x3::error_handler_result
-error_handler_base::on_error(Iterator& /*first*/, Iterator const& /*last*/,
+error_handler_base::on_error(Iterator& /*first*/, Iterator const& last,
                              Exception const& x, Context const& context)
 {
-    std::string which = x.which();
-    auto iter = id_map.find(which);
-    if (iter != id_map.end())
-        which = iter->second;
+    using recorder = std::decay_t<decltype(x3::get<error_recorder_tag>(context))>;
+    if constexpr (!std::is_same_v<recorder, x3::unused_type>)
+    {
+        static_assert(std::is_same_v<Iterator, char const*>,
+                      "errors are only recorded when parsing from memory");
+        // Point past the whitespace the report would skip as well
+        Iterator where = x.where();
+        while (where != last && std::isspace(static_cast<unsigned char>(*where)))
+            ++where;
+        error_recorder& r = x3::get<error_recorder_tag>(context).get();
+        r.error.offset = static_cast<std::size_t>(where - r.first);
+        r.error.expected = classify(x.which());
+        r.failed = true;
+    }
+    else
+    {
+        std::string const& which = x.which();
+        expectation const expected = classify(which);
 
-    std::string message = "Error! Expecting: " + which + " here:";
-    auto& error_handler = x3::get<error_handler_tag>(context).get();
-    error_handler(x.where(), message);
+        std::string message = "Error! Expecting: ";
+        if (expected == expectation::other)
+            message += which;
+        else
+            message += describe(expected);
+        message += " here:";
+        auto& error_handler = x3::get<error_handler_tag>(context).get();
+        error_handler(x.where(), message);
+    }
     return x3::error_handler_result::fail;
 }
 } // namespace rexpr::parser
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "parse_error.hpp"
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+
+namespace rexpr
+{
+///////////////////////////////////////////////////////////////////////////
+//  Event-based (SAX style) rexpr parsing
+//
+//  The grammar of rexpr_def.hpp with semantic actions in place of
+//  attributes: instead of building an AST, the parser reports what it sees
+//  to an event_handler. The views point into the parsed buffer and are
+//  only valid during the call. Nothing is allocated per entry, so memory
+//  use does not depend on the size of the document.
+///////////////////////////////////////////////////////////////////////////
+class event_handler
+{
+public:
+    virtual ~event_handler() = default;
+
+    virtual void begin_map() {}
+    virtual void key(std::string_view /*k*/) {}
+    virtual void string_value(std::string_view /*text*/) {}
+    virtual void integer_value(std::int64_t /*value*/) {}
+    virtual void real_value(double /*value*/) {}
+    virtual void bool_value(bool /*value*/) {}
+    virtual void end_map() {}
+
+    virtual void begin_array() {}
+    virtual void end_array() {}
+};
+
+// Parses the single rexpr in [first, last). Errors are reported to err in
+// the same format as the rexpr parser; events already delivered for a
+// malformed document are not taken back.
+bool parse_events(char const* first, char const* last, event_handler& handler,
+                  std::ostream& err, std::string const& file = "");
+
+// The same, but a failure is only recorded in `error`; no message is
+// formatted or written unless report() is called with it
+bool parse_events(char const* first, char const* last, event_handler& handler,
+                  parse_error& error);
+
+// Checks that [first, last) holds a single well-formed rexpr, without
+// building anything or formatting any message
+bool validate(char const* first, char const* last, parse_error& error);
+} // namespace rexpr
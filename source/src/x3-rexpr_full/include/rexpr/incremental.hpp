@@ -0,0 +1,68 @@
+#pragma once
+
+#include "ast.hpp"
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace rexpr
+{
+///////////////////////////////////////////////////////////////////////////
+//  A rexpr document that is re-parsed incrementally as it is edited
+//
+//  The source span of every nested rexpr is kept from the position
+//  annotations of the last parse. An edit re-parses only the innermost
+//  rexpr whose braces enclose it and splices the result into the AST; when
+//  that does not parse on its own, the whole document is parsed again.
+///////////////////////////////////////////////////////////////////////////
+class incremental_parser
+{
+public:
+    enum class reparse
+    {
+        partial, // only the enclosing rexpr was parsed again
+        full,    // the whole document was parsed again
+        failed   // the document does not parse; errors went to err
+    };
+
+    incremental_parser(std::string text, std::ostream& err, std::string file = "");
+
+    // The spans point into the AST
+    incremental_parser(incremental_parser const&) = delete;
+    incremental_parser& operator=(incremental_parser const&) = delete;
+
+    // Replaces `removed` bytes at `offset` with `inserted`
+    reparse edit(std::size_t offset, std::size_t removed, std::string_view inserted);
+
+    // While !ok(), ast() is the last document that parsed
+    bool ok() const { return ok_; }
+    ast::rexpr const& ast() const { return root_; }
+    std::string const& text() const { return text_; }
+
+    // How much of the text the last parse covered
+    std::size_t last_reparsed_bytes() const { return reparsed_; }
+
+private:
+    struct span
+    {
+        std::size_t first = 0; // the '{'
+        std::size_t last = 0;  // one past the '}'
+        ast::rexpr* node = nullptr;
+        std::vector<span> children; // ordered by position
+    };
+
+    bool parse_all();
+    bool parse_block(span& block);
+
+    std::string text_;
+    std::ostream& err_;
+    std::string file_;
+    ast::rexpr root_;
+    span spans_;
+    bool ok_ = false;
+    std::size_t reparsed_ = 0;
+};
+} // namespace rexpr
@@ -0,0 +1,8 @@
+#pragma once
+
+#include "io/mapped_file.hpp"
+
+namespace rexpr
+{
+using io::mapped_file;
+} // namespace rexpr
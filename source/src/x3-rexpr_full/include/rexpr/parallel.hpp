@@ -0,0 +1,32 @@
+#pragma once
+
+#include "ast.hpp"
+
+#include <cstddef>
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace rexpr
+{
+///////////////////////////////////////////////////////////////////////////
+//  Multi-threaded parsing of one large rexpr
+//
+//  A structural scan first finds where each top-level key/value entry
+//  starts. The entries are then split into byte-balanced chunks, the chunks
+//  are parsed on separate threads, and their maps are merged in order.
+///////////////////////////////////////////////////////////////////////////
+
+// Where each top-level entry of the rexpr in [first, last) starts, followed
+// by the position of its closing '}'. Empty if the braces, brackets and
+// quotes do not balance; the input may still be malformed otherwise.
+std::vector<char const*> scan_entries(char const* first, char const* last);
+
+// Parses the rexpr in [first, last) using up to `threads` threads (0 means
+// one per core). Errors are reported to err exactly as by the serial parser,
+// which is used for small or malformed input. Position annotations are not
+// meaningful in the result.
+std::optional<ast::rexpr> parse_parallel(char const* first, char const* last, std::ostream& err,
+                                         unsigned threads = 0, std::string const& file = "");
+} // namespace rexpr
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+
+namespace rexpr
+{
+///////////////////////////////////////////////////////////////////////////
+//  Recorded parse errors
+//
+//  What the grammar expected where a parse failed, kept as a small value
+//  instead of a formatted message. The message is only produced when
+//  report() is called.
+///////////////////////////////////////////////////////////////////////////
+enum class expectation : std::uint8_t
+{
+    rexpr,
+    value,
+    array,
+    key_value,
+    equals,
+    close_brace,
+    close_bracket,
+    end_of_input,
+    other // a parser outside the rexpr grammar
+};
+
+struct parse_error
+{
+    std::size_t offset = 0; // from the start of the parsed buffer
+    expectation expected = expectation::other;
+};
+
+namespace detail
+{
+struct expectation_name
+{
+    std::string_view which; // as X3 names the failed parser
+    std::string_view text;  // as error messages name it
+};
+
+// Indexed by expectation
+inline constexpr expectation_name expectation_names[] = {
+    {"rexpr", "RExpression"},
+    {"rexpr_value", "Value"},
+    {"rexpr_array", "Array"},
+    {"rexpr_key_value", "Key value pair"},
+    {"'='", "'='"},
+    {"'}'", "'}'"},
+    {"']'", "']'"},
+    {"", "end of input"},
+    {"", "unknown"},
+};
+} // namespace detail
+
+inline std::string_view describe(expectation e)
+{
+    return detail::expectation_names[static_cast<std::size_t>(e)].text;
+}
+
+// The expectation X3 reports as `which` for a failed expectation
+inline expectation classify(std::string_view which)
+{
+    auto const count = static_cast<std::size_t>(expectation::end_of_input);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        if (detail::expectation_names[i].which == which)
+            return static_cast<expectation>(i);
+    }
+    return expectation::other;
+}
+
+// Writes the message the reporting parsers write for error, found in the
+// buffer [first, last), with `file` as the file name
+void report(std::ostream& err, char const* first, char const* last,
+            parse_error const& error, std::string const& file = "");
+} // namespace rexpr
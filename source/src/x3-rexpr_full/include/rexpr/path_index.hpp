@@ -0,0 +1,66 @@
+#pragma once
+
+#include "ast.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace rexpr
+{
+///////////////////////////////////////////////////////////////////////////
+//  A flat path -> value table over a parsed rexpr
+//
+//  Every value in the tree, nested rexprs included, is entered under its
+//  full path of keys, e.g. {"position", "x"}. Lookups hash the path once and
+//  probe an open-addressing table instead of descending through the nested
+//  maps. The index points into the rexpr, which must outlive it. Keys may
+//  not contain '"', which separates them in a path; building an index or a
+//  path with such a key throws std::invalid_argument.
+///////////////////////////////////////////////////////////////////////////
+class path_index
+{
+public:
+    // A path with its hash computed up front, for repeated lookups
+    class path
+    {
+    public:
+        path(std::initializer_list<std::string_view> keys);
+        explicit path(std::vector<std::string> const& keys);
+
+    private:
+        friend class path_index;
+
+        void append(std::string_view key);
+
+        std::string encoded_; // the keys, each followed by '"'
+        std::uint64_t hash_ = 0;
+    };
+
+    explicit path_index(ast::rexpr const& root);
+
+    // nullptr if there is no value at that path
+    ast::rexpr_value const* find(path const& p) const;
+
+    std::size_t size() const { return size_; }
+
+private:
+    struct slot
+    {
+        std::uint64_t hash = 0;
+        std::uint32_t key_offset = 0;
+        std::uint32_t key_size = 0;
+        ast::rexpr_value const* value = nullptr;
+    };
+
+    void add(ast::rexpr const& node, std::string& prefix);
+    void insert(std::string_view key, std::uint64_t hash, ast::rexpr_value const& value);
+
+    std::vector<slot> slots_; // a power of two in size, at most half full
+    std::string keys_;        // the encoded paths of all slots
+    std::size_t size_ = 0;
+};
+} // namespace rexpr
@@ -8,7 +8,14 @@
 
 #include "ast.hpp"
 
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
 #include <ostream>
+#include <string>
 
 namespace rexpr::ast
 {
@@ -17,6 +24,38 @@ namespace rexpr::ast
 ///////////////////////////////////////////////////////////////////////////
 int const tabsize = 4;
 
+// Room for any text from format_real
+std::size_t const max_real_chars = 32;
+
+// Writes the shortest text that reads back as the same double, always with a
+// fraction or an exponent so that it does not read back as an integer, to the
+// max_real_chars bytes at first. Returns the end of the text.
+inline char* format_real(double value, char* first)
+{
+    auto const copy = [first](char const* text) {
+        return std::copy(text, text + std::strlen(text), first);
+    };
+    if (std::isnan(value))
+        return copy("nan");
+    if (std::isinf(value))
+        return copy(value < 0 ? "-inf" : "inf");
+
+    // Leaves room for ".0"
+    char* last = std::to_chars(first, first + max_real_chars - 2, value).ptr;
+    if (std::find_if(first, last, [](char c) { return c == '.' || c == 'e'; }) == last)
+    {
+        *last++ = '.';
+        *last++ = '0';
+    }
+    return last;
+}
+
+inline std::string format_real(double value)
+{
+    std::array<char, max_real_chars> buffer;
+    return std::string(buffer.data(), format_real(value, buffer.data()));
+}
+
 struct rexpr_printer
 {
     typedef void result_type;
@@ -38,11 +77,40 @@ struct rexpr_printer
         out << '}' << std::endl;
     }
 
+    void operator()(rexpr_array const& ast) const
+    {
+        out << '[' << std::endl;
+        for (auto const& element : ast.elements)
+        {
+            tab(indent + tabsize);
+            boost::apply_visitor(rexpr_printer(out, indent + tabsize), element);
+        }
+        tab(indent);
+        out << ']' << std::endl;
+    }
+
     void operator()(std::string const& text) const
     {
         out << '"' << text << '"' << std::endl;
     }
 
+    void operator()(std::int64_t value) const
+    {
+        out << value << std::endl;
+    }
+
+    void operator()(double value) const
+    {
+        std::array<char, max_real_chars> buffer;
+        out.write(buffer.data(), format_real(value, buffer.data()) - buffer.data());
+        out << std::endl;
+    }
+
+    void operator()(bool value) const
+    {
+        out << (value ? "true" : "false") << std::endl;
+    }
+
     void tab(int spaces) const
     {
         for (int i = 0; i < spaces; ++i)
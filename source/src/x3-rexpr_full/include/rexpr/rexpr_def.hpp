@@ -26,6 +26,7 @@ using ascii::string;
 struct rexpr_value_class;
 struct rexpr_key_value_class;
 struct rexpr_inner_class;
+struct rexpr_array_class;
 
 ///////////////////////////////////////////////////////////////////////////
 // Rules
@@ -38,21 +39,76 @@ x3::rule<rexpr_key_value_class, ast::rexpr_key_value> const rexpr_key_value =
 
 x3::rule<rexpr_inner_class, ast::rexpr> const rexpr_inner = "rexpr";
 
+x3::rule<rexpr_array_class, ast::rexpr_array> const rexpr_array = "rexpr_array";
+
 rexpr_type const rexpr = "rexpr";
 
 ///////////////////////////////////////////////////////////////////////////
 // Grammar
+//
+// The structure of the grammar is written once, for any variant G of it.
+// A variant supplies its rules (value, key_value, inner, array), its
+// leaves (string, key, real, integer, boolean) and its brackets (open_map,
+// close_map, open_array, close_array), each with whatever actions it
+// needs. The AST grammar below is the variant without actions; the event
+// parser (events.cpp) is another.
 ///////////////////////////////////////////////////////////////////////////
 
-auto const quoted_string = lexeme['"' >> *(char_ - '"') >> '"'];
+template <typename G>
+auto value_def()
+{
+    return G::string | G::real | G::integer | G::boolean | G::array | G::inner;
+}
 
-auto const rexpr_value_def = quoted_string | rexpr_inner;
+template <typename G>
+auto array_def()
+{
+    return G::open_array > *G::value > G::close_array;
+}
 
-auto const rexpr_key_value_def = quoted_string > '=' > rexpr_value;
+template <typename G>
+auto key_value_def()
+{
+    return G::key > '=' > G::value;
+}
 
-auto const rexpr_inner_def = '{' > *rexpr_key_value > '}';
+template <typename G>
+auto inner_def()
+{
+    return G::open_map > *G::key_value > G::close_map;
+}
+
+// A quoted string whose characters are parsed by chars(p), e.g. raw[p]
+template <typename Chars>
+auto quoted(Chars const& chars)
+{
+    return lexeme['"' >> chars(*(char_ - '"')) >> '"'];
+}
 
-auto const rexpr_def = rexpr_inner_def;
+auto const quoted_string = quoted([](auto const& p) { return p; });
+
+// Reals need a fraction or an exponent; anything else is an integer
+auto const real = x3::real_parser<double, x3::strict_real_policies<double>>();
+auto const integer = x3::int_parser<std::int64_t>();
+
+struct ast_grammar
+{
+    static constexpr auto const& value = rexpr_value;
+    static constexpr auto const& key_value = rexpr_key_value;
+    static constexpr auto const& inner = rexpr_inner;
+    static constexpr auto const& array = rexpr_array;
+
+    static constexpr auto const& string = quoted_string;
+    static constexpr auto const& key = quoted_string;
+    static constexpr auto const& real = parser::real;
+    static constexpr auto const& integer = parser::integer;
+    static constexpr auto const& boolean = x3::bool_;
+
+    static constexpr auto open_map = lit('{');
+    static constexpr auto close_map = lit('}');
+    static constexpr auto open_array = lit('[');
+    static constexpr auto close_array = lit(']');
+};
 
 //BOOST_SPIRIT_DEFINE(rexpr_value, rexpr, rexpr_inner, rexpr_key_value)
 
@@ -61,7 +117,7 @@ inline bool parse_rule(decltype(rexpr_value), Iterator& first, Iterator const& l
                        Context const& context, Attribute& attr)
 {
     using boost::spirit::x3::unused;
-    static auto const def_ = (rexpr_value = rexpr_value_def);
+    static auto const def_ = (rexpr_value = value_def<ast_grammar>());
     return def_.parse(first, last, context, unused, attr);
 }
 
@@ -70,7 +126,7 @@ inline bool parse_rule(decltype(rexpr), Iterator& first, Iterator const& last,
                        Context const& context, Attribute& attr)
 {
     using boost::spirit::x3::unused;
-    static auto const def_ = (rexpr = rexpr_def);
+    static auto const def_ = (rexpr = inner_def<ast_grammar>());
     return def_.parse(first, last, context, unused, attr);
 }
 
@@ -79,7 +135,16 @@ inline bool parse_rule(decltype(rexpr_inner), Iterator& first, Iterator const& l
                        Context const& context, Attribute& attr)
 {
     using boost::spirit::x3::unused;
-    static auto const def_ = (rexpr_inner = rexpr_inner_def);
+    static auto const def_ = (rexpr_inner = inner_def<ast_grammar>());
+    return def_.parse(first, last, context, unused, attr);
+}
+
+template <typename Iterator, typename Context, typename Attribute>
+inline bool parse_rule(decltype(rexpr_array), Iterator& first, Iterator const& last,
+                       Context const& context, Attribute& attr)
+{
+    using boost::spirit::x3::unused;
+    static auto const def_ = (rexpr_array = array_def<ast_grammar>());
     return def_.parse(first, last, context, unused, attr);
 }
 
@@ -88,7 +153,7 @@ inline bool parse_rule(decltype(rexpr_key_value), Iterator& first, Iterator cons
                        Context const& context, Attribute& attr)
 {
     using boost::spirit::x3::unused;
-    static auto const def_ = (rexpr_key_value = rexpr_key_value_def);
+    static auto const def_ = (rexpr_key_value = key_value_def<ast_grammar>());
     return def_.parse(first, last, context, unused, attr);
 }
 
@@ -106,6 +171,9 @@ struct rexpr_key_value_class : x3::annotate_on_success
 struct rexpr_inner_class : x3::annotate_on_success
 {
 };
+struct rexpr_array_class : x3::annotate_on_success
+{
+};
 
 // We want error-handling only for the start (outermost) rexpr
 // rexpr is the same as rexpr_inner but without error-handling (see error_handler.hpp)
@@ -113,11 +181,3 @@ struct rexpr_class : x3::annotate_on_success, error_handler_base
 {
 };
 } // namespace rexpr::parser
-
-namespace rexpr
-{
-parser::rexpr_type const& rexpr()
-{
-    return parser::rexpr;
-}
-} // namespace rexpr
@@ -0,0 +1,312 @@
+#pragma once
+
+#include "config.hpp"
+
+#include <boost/fusion/include/adapt_struct.hpp>
+#include <boost/fusion/include/at_c.hpp>
+#include <boost/fusion/include/is_sequence.hpp>
+#include <boost/fusion/include/size.hpp>
+#include <boost/spirit/home/x3.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace rexpr::schema
+{
+///////////////////////////////////////////////////////////////////////////
+//  Typed extraction straight from rexpr text
+//
+//  The schema is a struct adapted with BOOST_FUSION_ADAPT_STRUCT: each
+//  member is filled from the entry whose key is the member's name. Members
+//  may be std::string, std::string_view (a view into the source), bool
+//  (true/false), arithmetic types (from native numbers or, as before typed
+//  values existed, from quoted text), std::vector of any of these (arrays,
+//  std::vector<bool> included) or other adapted structs (nested rexprs).
+//  Entries the schema does not name are skipped by scanning for the
+//  matching quote, brace or bracket, without being validated or stored.
+//  Members without an entry keep their value.
+///////////////////////////////////////////////////////////////////////////
+namespace x3 = boost::spirit::x3;
+
+namespace detail
+{
+template <typename Iterator>
+[[noreturn]] void expect(Iterator where, char const* what)
+{
+    boost::throw_exception(x3::expectation_failure<Iterator>(where, what));
+}
+
+// The contents of a quoted string at first, which is left past it
+template <typename Iterator>
+std::pair<Iterator, Iterator> quoted(Iterator& first, Iterator const& last,
+                                     char const* what)
+{
+    if (first == last || *first != '"')
+        expect(first, what);
+    Iterator const begin = ++first;
+    first = std::find(first, last, '"');
+    if (first == last)
+        expect(first, "'\"'");
+    return {begin, first++};
+}
+
+template <typename Iterator>
+std::string_view view(std::pair<Iterator, Iterator> const& text)
+{
+    return {&*text.first, static_cast<std::size_t>(text.second - text.first)};
+}
+
+inline bool is_delimiter(char c)
+{
+    switch (c)
+    {
+    case '"': case '{': case '}': case '[': case ']': case '=':
+    case ' ': case '\t': case '\n': case '\r': case '\v': case '\f': return true;
+    default: return false;
+    }
+}
+
+// A number or boolean at first, quoted or not, which is left past it
+template <typename Iterator>
+std::pair<Iterator, Iterator> scalar(Iterator& first, Iterator const& last,
+                                     char const* what)
+{
+    if (first != last && *first == '"')
+        return quoted(first, last, what);
+    Iterator const begin = first;
+    while (first != last && !is_delimiter(*first))
+        ++first;
+    if (first == begin)
+        expect(first, what);
+    return {begin, first};
+}
+
+// Skips a value of any shape, only checking that quotes and brackets balance
+template <typename Iterator>
+void skip_value(Iterator& first, Iterator const& last)
+{
+    if (first == last)
+        expect(first, "Value");
+    if (*first == '"')
+    {
+        quoted(first, last, "Value");
+        return;
+    }
+    if (*first != '{' && *first != '[')
+    {
+        scalar(first, last, "Value");
+        return;
+    }
+
+    // The closing bracket of each open brace or bracket, innermost last
+    std::string closers;
+    do
+    {
+        if (first == last)
+            expect(first, closers.back() == '}' ? "'}'" : "']'");
+        if (*first == '"')
+            quoted(first, last, "'\"'");
+        else if (*first == '{')
+            closers += '}', ++first;
+        else if (*first == '[')
+            closers += ']', ++first;
+        else if (*first == '}' || *first == ']')
+        {
+            if (*first != closers.back())
+                expect(first, closers.back() == '}' ? "'}'" : "']'");
+            closers.pop_back(), ++first;
+        }
+        else
+            ++first;
+    } while (!closers.empty());
+}
+
+template <typename T>
+using is_struct = boost::fusion::traits::is_sequence<T>;
+
+template <typename T>
+struct is_vector : std::false_type
+{
+};
+
+template <typename T, typename Allocator>
+struct is_vector<std::vector<T, Allocator>> : std::true_type
+{
+};
+
+template <typename Iterator, typename Context, typename T>
+bool parse_struct(Iterator& first, Iterator const& last, Context const& context, T& out);
+
+template <typename Iterator, typename Context, typename T>
+void parse_value(Iterator& first, Iterator const& last, Context const& context, T& out)
+{
+    if constexpr (is_struct<T>::value)
+    {
+        if (!parse_struct(first, last, context, out))
+            expect(first, "Value");
+    }
+    else if constexpr (std::is_same_v<T, std::string>)
+    {
+        auto const text = quoted(first, last, "string");
+        out.assign(text.first, text.second);
+    }
+    else if constexpr (std::is_same_v<T, std::string_view>)
+    {
+        static_assert(std::is_pointer_v<Iterator>,
+                      "string_view members need char const* input");
+        out = view(quoted(first, last, "string"));
+    }
+    else if constexpr (std::is_same_v<T, bool>)
+    {
+        auto const where = first;
+        auto const word = view(scalar(first, last, "boolean"));
+        if (word != "true" && word != "false")
+            expect(where, "boolean");
+        out = word == "true";
+    }
+    else if constexpr (std::is_arithmetic_v<T>)
+    {
+        auto const where = first;
+        auto text = scalar(first, last, "number");
+        bool ok = false;
+        if constexpr (std::is_integral_v<T>)
+            ok = x3::parse(text.first, text.second, x3::int_parser<T>(), out);
+        else
+            ok = x3::parse(text.first, text.second, x3::real_parser<T>(), out);
+        if (!ok || text.first != text.second)
+            expect(where, "number");
+    }
+    else if constexpr (is_vector<T>::value)
+    {
+        if (first == last || *first != '[')
+            expect(first, "Array");
+        ++first;
+        out.clear();
+        for (;;)
+        {
+            x3::skip_over(first, last, context);
+            if (first != last && *first == ']')
+                break;
+            if (first == last)
+                expect(first, "']'");
+            if constexpr (std::is_same_v<T, std::vector<bool>>)
+            {
+                // vector<bool> has no bool& to parse into
+                bool element = false;
+                parse_value(first, last, context, element);
+                out.push_back(element);
+            }
+            else
+                parse_value(first, last, context, out.emplace_back());
+        }
+        ++first;
+    }
+    else
+    {
+        static_assert(is_struct<T>::value, "unsupported schema member type");
+    }
+}
+
+// Parses the value into the member named key, if there is one
+template <typename Iterator, typename Context, typename T, std::size_t... I>
+bool parse_member(std::string_view key, Iterator& first, Iterator const& last,
+                  Context const& context, T& out, std::array<bool, sizeof...(I)>& seen,
+                  std::index_sequence<I...>)
+{
+    using boost::fusion::extension::struct_member_name;
+
+    auto const member = [&](auto index) {
+        constexpr std::size_t i = decltype(index)::value;
+        if (seen[i] || key != struct_member_name<T, i>::call())
+            return false;
+        // Like the std::map in ast::rexpr, the first of duplicate keys wins
+        seen[i] = true;
+        parse_value(first, last, context, boost::fusion::at_c<i>(out));
+        return true;
+    };
+    return (member(std::integral_constant<std::size_t, I>()) || ...);
+}
+
+template <typename Iterator, typename Context, typename T>
+bool parse_struct(Iterator& first, Iterator const& last, Context const& context, T& out)
+{
+    constexpr std::size_t size = boost::fusion::result_of::size<T>::type::value;
+    std::array<bool, size> seen{};
+
+    x3::skip_over(first, last, context);
+    if (first == last || *first != '{')
+        return false;
+    ++first;
+
+    for (;;)
+    {
+        x3::skip_over(first, last, context);
+        if (first != last && *first == '}')
+        {
+            ++first;
+            return true;
+        }
+
+        auto const key = quoted(first, last, "'}'");
+        x3::skip_over(first, last, context);
+        if (first == last || *first != '=')
+            expect(first, "'='");
+        ++first;
+        x3::skip_over(first, last, context);
+
+        if (!parse_member(view(key), first, last, context, out, seen,
+                          std::make_index_sequence<size>()))
+            skip_value(first, last);
+    }
+}
+} // namespace detail
+
+template <typename T>
+struct struct_parser : x3::parser<struct_parser<T>>
+{
+    using attribute_type = T;
+    static bool const has_attribute = true;
+
+    template <typename Iterator, typename Context, typename RContext>
+    bool parse(Iterator& first, Iterator const& last, Context const& context,
+               RContext const&, T& attr) const
+    {
+        return detail::parse_struct(first, last, context, attr);
+    }
+};
+
+// Errors are reported like those of the rexpr grammar
+struct schema_class : parser::error_handler_base
+{
+};
+
+template <typename T>
+bool extract(char const* first, char const* last, T& out, std::ostream& err,
+             std::string const& file = "")
+{
+    using boost::spirit::x3::with;
+    using boost::spirit::x3::ascii::space;
+    using parser::error_handler_tag;
+
+    parser::pointer_error_handler_type error_handler(first, last, err, file);
+    auto const rule = (x3::rule<schema_class, T>("rexpr") = struct_parser<T>());
+    auto const p = with<error_handler_tag>(std::ref(error_handler))[rule];
+
+    char const* iter = first;
+    if (!phrase_parse(iter, last, p, space, out))
+        return false;
+    if (iter != last)
+    {
+        error_handler(iter, "Error! Expecting end of input here: ");
+        return false;
+    }
+    return true;
+}
+} // namespace rexpr::schema
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "ast.hpp"
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace rexpr
+{
+///////////////////////////////////////////////////////////////////////////
+//  Buffered rexpr output
+//
+//  pretty produces the same text as ast::rexpr_printer; compact leaves out
+//  all optional whitespace. Each top-level rexpr ends with a newline, so
+//  the output of several writes can be read back with parse_all.
+///////////////////////////////////////////////////////////////////////////
+enum class layout
+{
+    compact,
+    pretty
+};
+
+class serializer
+{
+public:
+    // Collect the output in memory
+    explicit serializer(layout l = layout::pretty);
+
+    // Write the output to fd whenever flush_at bytes have accumulated
+    // (and on flush() and destruction). The fd is not closed.
+    serializer(int fd, layout l = layout::pretty, std::size_t flush_at = 64 * 1024);
+
+    ~serializer();
+
+    serializer(serializer const&) = delete;
+    serializer& operator=(serializer const&) = delete;
+
+    void write(ast::rexpr const& r);
+
+    // Throws std::system_error if writing to the fd fails
+    void flush();
+
+    // What has not been flushed yet
+    std::string_view buffer() const { return buffer_; }
+    void clear() { buffer_.clear(); }
+
+private:
+    void write(ast::rexpr const& r, std::size_t indent);
+    void write(ast::rexpr_array const& a, std::size_t indent);
+    void write(ast::rexpr_value const& value, std::size_t indent);
+    void write_quoted(std::string const& text);
+
+    std::string buffer_;
+    layout layout_;
+    int fd_ = -1;
+    std::size_t flush_at_ = 0;
+};
+
+// Convenience: the serialized text of r
+std::string to_string(ast::rexpr const& r, layout l = layout::pretty);
+} // namespace rexpr
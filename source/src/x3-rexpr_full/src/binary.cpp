@@ -0,0 +1,313 @@
+#include "rexpr/binary.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace rexpr::binary
+{
+namespace
+{
+char const magic[4] = {'R', 'E', 'X', 'B'};
+std::uint32_t const byte_order = 0x01020304;
+std::size_t const header_size = 16;
+std::size_t const entry_size = 16;
+std::size_t const element_size = 8;
+
+std::uint32_t load(char const* p)
+{
+    std::uint32_t v;
+    std::memcpy(&v, p, sizeof v);
+    return v;
+}
+
+// Throws unless [offset, offset + size) lies within data of `bytes` bytes
+void check(std::size_t offset, std::size_t size, std::size_t bytes)
+{
+    if (offset > bytes || size > bytes - offset)
+        throw std::runtime_error("rexpr::binary: offset out of range");
+}
+
+// The element or entry count at offset, checked to fit with its items
+std::size_t checked_count(char const* data, std::size_t bytes, std::uint32_t offset,
+                          std::size_t item_size)
+{
+    check(offset, 4, bytes);
+    std::size_t const n = load(data + offset);
+    check(offset + std::size_t{4}, n * item_size, bytes);
+    return n;
+}
+
+void check_index(std::size_t i, std::size_t size)
+{
+    if (i >= size)
+        throw std::out_of_range("rexpr::binary: index out of range");
+}
+
+// Nested nodes and arrays are stored after the table that points at them, so
+// following them always moves forward and a corrupt offset cannot make a cycle
+void check_nested(std::uint32_t offset, std::uint32_t size, std::size_t table_end)
+{
+    if ((size == nested_rexpr || size == nested_array) && offset < table_end)
+        throw std::runtime_error("rexpr::binary: nested value before its parent");
+}
+
+class compiler
+{
+public:
+    std::string compile(ast::rexpr const& r)
+    {
+        out_.append(magic, sizeof magic);
+        append(version);
+        append(byte_order);
+        append(0);
+        store(12, add(r));
+        return std::move(out_);
+    }
+
+private:
+    std::uint32_t add(ast::rexpr const& r)
+    {
+        std::uint32_t const at = offset();
+        append(static_cast<std::uint32_t>(r.entries.size()));
+        out_.append(r.entries.size() * entry_size, '\0');
+
+        std::size_t i = 0;
+        for (auto const& entry : r.entries)
+        {
+            std::size_t const field = at + 4 + i++ * entry_size;
+            store(field, offset());
+            store(field + 4, length(entry.first));
+            out_.append(entry.first);
+
+            add(entry.second, field + 8);
+        }
+        return at;
+    }
+
+    std::uint32_t add(ast::rexpr_array const& a)
+    {
+        std::uint32_t const at = offset();
+        append(static_cast<std::uint32_t>(a.elements.size()));
+        out_.append(a.elements.size() * element_size, '\0');
+
+        std::size_t i = 0;
+        for (auto const& element : a.elements)
+            add(element, at + 4 + i++ * element_size);
+        return at;
+    }
+
+    // Stores the value's offset and size at field, appending its data
+    void add(ast::rexpr_value const& v, std::size_t field)
+    {
+        using ast::x3::forward_ast;
+
+        if (auto const text = boost::get<std::string>(&v))
+        {
+            store(field, offset());
+            store(field + 4, length(*text));
+            out_.append(*text);
+        }
+        else if (auto const i = boost::get<std::int64_t>(&v))
+        {
+            store(field, offset());
+            store(field + 4, integer);
+            out_.append(reinterpret_cast<char const*>(i), sizeof *i);
+        }
+        else if (auto const d = boost::get<double>(&v))
+        {
+            store(field, offset());
+            store(field + 4, real);
+            out_.append(reinterpret_cast<char const*>(d), sizeof *d);
+        }
+        else if (auto const b = boost::get<bool>(&v))
+        {
+            store(field, *b ? 1 : 0);
+            store(field + 4, boolean);
+        }
+        else if (auto const child = boost::get<forward_ast<ast::rexpr>>(&v))
+        {
+            std::uint32_t const at = add(child->get());
+            store(field, at);
+            store(field + 4, nested_rexpr);
+        }
+        else
+        {
+            auto const& a = boost::get<forward_ast<ast::rexpr_array>>(v).get();
+            std::uint32_t const at = add(a);
+            store(field, at);
+            store(field + 4, nested_array);
+        }
+    }
+
+    std::uint32_t offset() const { return length(out_); }
+
+    static std::uint32_t length(std::string const& s)
+    {
+        if (s.size() >= boolean)
+            throw std::length_error("rexpr::binary: more than 4 GB");
+        return static_cast<std::uint32_t>(s.size());
+    }
+
+    void append(std::uint32_t v) { out_.append(reinterpret_cast<char const*>(&v), sizeof v); }
+
+    void store(std::size_t at, std::uint32_t v) { std::memcpy(&out_[at], &v, sizeof v); }
+
+    std::string out_;
+};
+} // namespace
+
+std::string compile(ast::rexpr const& r)
+{
+    return compiler().compile(r);
+}
+
+std::string_view value::text() const
+{
+    check(offset_, size_, bytes_);
+    return {data_ + offset_, size_};
+}
+
+std::int64_t value::as_integer() const
+{
+    std::int64_t v;
+    check(offset_, sizeof v, bytes_);
+    std::memcpy(&v, data_ + offset_, sizeof v);
+    return v;
+}
+
+double value::as_real() const
+{
+    double v;
+    check(offset_, sizeof v, bytes_);
+    std::memcpy(&v, data_ + offset_, sizeof v);
+    return v;
+}
+
+node value::rexpr() const
+{
+    return node(data_, bytes_, offset_);
+}
+
+array value::array() const
+{
+    return binary::array(data_, bytes_, offset_);
+}
+
+std::size_t array::size() const
+{
+    return checked_count(data_, bytes_, offset_, element_size);
+}
+
+value array::at(std::size_t i) const
+{
+    std::size_t const n = size();
+    check_index(i, n);
+    char const* const element = data_ + offset_ + 4 + i * element_size;
+    std::uint32_t const offset = load(element);
+    std::uint32_t const tag = load(element + 4);
+    check_nested(offset, tag, offset_ + 4 + n * element_size);
+    return value(data_, bytes_, offset, tag);
+}
+
+std::size_t node::size() const
+{
+    return checked_count(data_, bytes_, offset_, entry_size);
+}
+
+std::uint32_t node::field(std::size_t i, std::size_t f) const
+{
+    check_index(i, size());
+    return load(data_ + offset_ + 4 + i * entry_size + f * 4);
+}
+
+std::string_view node::key(std::size_t i) const
+{
+    std::uint32_t const offset = field(i, 0);
+    std::uint32_t const size = field(i, 1);
+    check(offset, size, bytes_);
+    return {data_ + offset, size};
+}
+
+value node::at(std::size_t i) const
+{
+    std::uint32_t const offset = field(i, 2);
+    std::uint32_t const tag = field(i, 3);
+    check_nested(offset, tag, offset_ + 4 + size() * entry_size);
+    return value(data_, bytes_, offset, tag);
+}
+
+std::optional<value> node::find(std::string_view k) const
+{
+    std::size_t first = 0;
+    std::size_t count = size();
+    while (count != 0)
+    {
+        std::size_t const half = count / 2;
+        if (key(first + half) < k)
+        {
+            first += half + 1;
+            count -= half + 1;
+        }
+        else
+        {
+            count = half;
+        }
+    }
+    if (first != size() && key(first) == k)
+        return at(first);
+    return std::nullopt;
+}
+
+node root(std::string_view data)
+{
+    if (data.size() < header_size || std::memcmp(data.data(), magic, sizeof magic) != 0)
+        throw std::runtime_error("rexpr::binary: not a compiled rexpr");
+    if (load(data.data() + 4) != version || load(data.data() + 8) != byte_order)
+        throw std::runtime_error("rexpr::binary: unsupported version or byte order");
+
+    std::uint32_t const offset = load(data.data() + 12);
+    if (offset > data.size() - 4)
+        throw std::runtime_error("rexpr::binary: truncated data");
+    return node(data.data(), data.size(), offset);
+}
+
+namespace
+{
+ast::rexpr_value to_ast(value const& v)
+{
+    if (v.is_rexpr())
+        return ast::rexpr_value(binary::to_ast(v.rexpr()));
+    if (v.is_array())
+    {
+        ast::rexpr_array result;
+        auto const a = v.array();
+        for (std::size_t i = 0; i != a.size(); ++i)
+            result.elements.push_back(to_ast(a.at(i)));
+        return ast::rexpr_value(std::move(result));
+    }
+    if (v.is_integer())
+        return ast::rexpr_value(v.as_integer());
+    if (v.is_real())
+        return ast::rexpr_value(v.as_real());
+    if (v.is_boolean())
+        return ast::rexpr_value(v.as_boolean());
+    return ast::rexpr_value(std::string(v.text()));
+}
+} // namespace
+
+ast::rexpr to_ast(node const& n)
+{
+    ast::rexpr result;
+    for (std::size_t i = 0; i != n.size(); ++i)
+        result.entries.emplace(n.key(i), to_ast(n.at(i)));
+    return result;
+}
+
+file::file(std::string const& path)
+    : mapping_(std::make_unique<mapped_file const>(path)),
+      root_(binary::root(std::string_view(mapping_->begin(), mapping_->size())))
+{
+}
+} // namespace rexpr::binary
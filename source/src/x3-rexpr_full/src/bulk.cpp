@@ -0,0 +1,40 @@
+#include "rexpr/bulk.hpp"
+#include "rexpr/config.hpp"
+#include "rexpr/rexpr_def.hpp"
+
+#include <cctype>
+
+namespace rexpr
+{
+bulk_result parse_all(char const* first, char const* last, rexpr_callback const& on_rexpr,
+                      std::ostream& err, std::string const& file)
+{
+    using boost::spirit::x3::with;
+    using boost::spirit::x3::ascii::space;
+    using parser::error_handler_tag;
+    using parser::pointer_error_handler_type;
+
+    bulk_result result;
+    char const* iter = first;
+    while (iter != last && std::isspace(static_cast<unsigned char>(*iter)))
+        ++iter;
+
+    while (iter != last)
+    {
+        char const* const start = iter;
+        pointer_error_handler_type error_handler(first, last, err, file);
+        auto const parser = with<error_handler_tag>(std::ref(error_handler))[rexpr()];
+
+        ast::rexpr ast;
+        if (!phrase_parse(iter, last, parser, space, ast))
+        {
+            result.ok = false;
+            result.error_offset = static_cast<std::size_t>(start - first);
+            return result;
+        }
+        on_rexpr(std::move(ast));
+        ++result.count;
+    }
+    return result;
+}
+} // namespace rexpr
@@ -0,0 +1,199 @@
+#include "rexpr/document.hpp"
+#include "rexpr/events.hpp"
+#include "rexpr/printer.hpp"
+
+#include <algorithm>
+#include <ostream>
+
+namespace rexpr::flat
+{
+///////////////////////////////////////////////////////////////////////////
+//  Collects the entries reported by the event parser
+///////////////////////////////////////////////////////////////////////////
+class document_builder : public event_handler
+{
+public:
+    static std::optional<document> build(std::string_view source,
+                                         std::shared_ptr<void const> owner, std::ostream& err,
+                                         std::string const& file);
+
+    explicit document_builder(document& doc) : doc_(doc) {}
+
+    void begin_map() override { open(false); }
+    void begin_array() override { open(true); }
+
+    void key(std::string_view k) override { pending_.push_back({k, {}}); }
+
+    void string_value(std::string_view t) override { slot().text = t; }
+
+    void integer_value(std::int64_t v) override
+    {
+        value& s = slot();
+        s.type = kind::integer;
+        s.integer = v;
+    }
+
+    void real_value(double v) override
+    {
+        value& s = slot();
+        s.type = kind::real;
+        s.real = v;
+    }
+
+    void bool_value(bool v) override
+    {
+        value& s = slot();
+        s.type = kind::boolean;
+        s.boolean = v;
+    }
+
+    void end_map() override { close(kind::rexpr); }
+    void end_array() override { close(kind::array); }
+
+private:
+    struct container
+    {
+        std::size_t start; // where its entries start in pending_
+        bool is_array;
+    };
+
+    // The value about to be reported: that of the last key, or a new element
+    value& slot()
+    {
+        if (!open_.empty() && open_.back().is_array)
+            pending_.emplace_back();
+        return pending_.back().val;
+    }
+
+    void open(bool is_array)
+    {
+        if (!open_.empty())
+            slot();
+        open_.push_back({pending_.size(), is_array});
+    }
+
+    // Moves the entries of the innermost open container into the document.
+    // Those of a rexpr are sorted by key and, like the std::map in
+    // ast::rexpr, the first of duplicate keys wins.
+    void close(kind type)
+    {
+        auto const start = static_cast<std::ptrdiff_t>(open_.back().start);
+        auto const first = pending_.begin() + start;
+        auto last = pending_.end();
+        open_.pop_back();
+
+        if (type == kind::rexpr)
+        {
+            std::stable_sort(first, last,
+                             [](entry const& a, entry const& b) { return a.key < b.key; });
+            last = std::unique(first, last,
+                               [](entry const& a, entry const& b) { return a.key == b.key; });
+        }
+
+        node n;
+        n.first = static_cast<std::uint32_t>(doc_.entries_.size());
+        n.size = static_cast<std::uint32_t>(last - first);
+        doc_.entries_.insert(doc_.entries_.end(), first, last);
+        pending_.erase(first, pending_.end());
+
+        doc_.nodes_.push_back(n);
+        if (!open_.empty())
+        {
+            value& parent = pending_.back().val;
+            parent.type = type;
+            parent.child = static_cast<std::uint32_t>(doc_.nodes_.size() - 1);
+        }
+    }
+
+    document& doc_;
+    std::vector<entry> pending_;  // entries of the containers still open
+    std::vector<container> open_; // innermost last
+};
+
+namespace
+{
+int const tabsize = 4;
+
+void tab(std::ostream& out, int spaces)
+{
+    for (int i = 0; i < spaces; ++i)
+        out << ' ';
+}
+
+void print(std::ostream& out, document const& doc, value const& v, int indent);
+
+void print(std::ostream& out, document const& doc, node const& n, bool is_array,
+           int indent)
+{
+    out << (is_array ? '[' : '{') << std::endl;
+    for (auto e = doc.begin(n); e != doc.end(n); ++e)
+    {
+        tab(out, indent + tabsize);
+        if (!is_array)
+            out << '"' << e->key << "\" = ";
+        print(out, doc, e->val, indent + tabsize);
+    }
+    tab(out, indent);
+    out << (is_array ? ']' : '}') << std::endl;
+}
+
+void print(std::ostream& out, document const& doc, value const& v, int indent)
+{
+    switch (v.type)
+    {
+    case kind::string: out << '"' << v.text << '"' << std::endl; break;
+    case kind::integer: out << v.integer << std::endl; break;
+    case kind::real: out << ast::format_real(v.real) << std::endl; break;
+    case kind::boolean: out << (v.boolean ? "true" : "false") << std::endl; break;
+    case kind::rexpr: print(out, doc, doc.child(v), false, indent); break;
+    case kind::array: print(out, doc, doc.child(v), true, indent); break;
+    }
+}
+} // namespace
+
+std::optional<document> document_builder::build(std::string_view source,
+                                                std::shared_ptr<void const> owner,
+                                                std::ostream& err, std::string const& file)
+{
+    document doc;
+    doc.source_ = source;
+    doc.owner_ = std::move(owner);
+
+    document_builder builder(doc);
+    if (!parse_events(source.data(), source.data() + source.size(), builder, err, file))
+        return std::nullopt;
+    return doc;
+}
+
+value const* document::find(node const& n, std::string_view key) const
+{
+    auto const e = std::lower_bound(begin(n), end(n), key,
+                                    [](entry const& a, std::string_view k) { return a.key < k; });
+    return e != end(n) && e->key == key ? &e->val : nullptr;
+}
+
+std::optional<document> parse_document(std::string_view source, std::ostream& err,
+                                       std::string const& file)
+{
+    return document_builder::build(source, nullptr, err, file);
+}
+
+std::optional<document> parse_document(std::shared_ptr<std::string const> source,
+                                       std::ostream& err, std::string const& file)
+{
+    std::string_view const text = *source;
+    return document_builder::build(text, std::move(source), err, file);
+}
+
+std::optional<document> parse_document(std::shared_ptr<mapped_file const> source,
+                                       std::ostream& err, std::string const& file)
+{
+    std::string_view const text(source->begin(), source->size());
+    return document_builder::build(text, std::move(source), err, file);
+}
+
+void print(std::ostream& out, document const& doc)
+{
+    print(out, doc, doc.root(), false, 0);
+}
+} // namespace rexpr::flat
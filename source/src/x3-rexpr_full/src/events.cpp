@@ -0,0 +1,164 @@
+/*=============================================================================
+    Copyright (c) 2001-2015 Joel de Guzman
+
+    Distributed under the Boost Software License, Version 1.0. (See accompanying
+    file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+=============================================================================*/
+#include "rexpr/events.hpp"
+#include "rexpr/config.hpp"
+#include "rexpr/rexpr_def.hpp"
+
+#include <boost/spirit/home/x3.hpp>
+
+namespace rexpr
+{
+namespace
+{
+///////////////////////////////////////////////////////////////////////////
+//  The rexpr grammar of rexpr_def.hpp, with actions instead of attributes
+///////////////////////////////////////////////////////////////////////////
+namespace grammar
+{
+namespace x3 = boost::spirit::x3;
+
+using x3::lit;
+using x3::raw;
+
+struct handler_tag;
+
+std::string_view view(boost::iterator_range<char const*> const& range)
+{
+    return {range.begin(), range.size()};
+}
+
+template <typename Context>
+event_handler& handler(Context const& ctx)
+{
+    return x3::get<handler_tag>(ctx).get();
+}
+
+auto const on_open = [](auto& ctx) { handler(ctx).begin_map(); };
+auto const on_close = [](auto& ctx) { handler(ctx).end_map(); };
+auto const on_key = [](auto& ctx) { handler(ctx).key(view(x3::_attr(ctx))); };
+auto const on_text = [](auto& ctx) { handler(ctx).string_value(view(x3::_attr(ctx))); };
+auto const on_integer = [](auto& ctx) { handler(ctx).integer_value(x3::_attr(ctx)); };
+auto const on_real = [](auto& ctx) { handler(ctx).real_value(x3::_attr(ctx)); };
+auto const on_bool = [](auto& ctx) { handler(ctx).bool_value(x3::_attr(ctx)); };
+auto const on_begin_array = [](auto& ctx) { handler(ctx).begin_array(); };
+auto const on_end_array = [](auto& ctx) { handler(ctx).end_array(); };
+
+struct rexpr_value_class;
+struct rexpr_key_value_class;
+struct rexpr_inner_class;
+struct rexpr_array_class;
+struct rexpr_class;
+struct close_brace_class;
+struct close_bracket_class;
+
+x3::rule<rexpr_value_class> const rexpr_value = "rexpr_value";
+x3::rule<rexpr_key_value_class> const rexpr_key_value = "rexpr_key_value";
+x3::rule<rexpr_inner_class> const rexpr_inner = "rexpr";
+x3::rule<rexpr_array_class> const rexpr_array = "rexpr_array";
+x3::rule<rexpr_class> const rexpr = "rexpr";
+
+// Named like the literals they wrap, so that errors read as in rexpr_def.hpp
+x3::rule<close_brace_class> const close_brace = "'}'";
+x3::rule<close_bracket_class> const close_bracket = "']'";
+
+auto const close_brace_def = lit('}')[on_close];
+auto const close_bracket_def = lit(']')[on_end_array];
+
+// Strings are kept as views of the buffer
+auto const quoted_view = parser::quoted([](auto const& p) { return raw[p]; });
+
+struct event_grammar
+{
+    static constexpr auto const& value = rexpr_value;
+    static constexpr auto const& key_value = rexpr_key_value;
+    static constexpr auto const& inner = rexpr_inner;
+    static constexpr auto const& array = rexpr_array;
+
+    static inline auto const string = quoted_view[on_text];
+    static inline auto const key = quoted_view[on_key];
+    static inline auto const real = parser::real[on_real];
+    static inline auto const integer = parser::integer[on_integer];
+    static inline auto const boolean = x3::bool_[on_bool];
+
+    static inline auto const open_map = lit('{')[on_open];
+    static constexpr auto const& close_map = close_brace;
+    static inline auto const open_array = lit('[')[on_begin_array];
+    static constexpr auto const& close_array = close_bracket;
+};
+
+auto const rexpr_value_def = parser::value_def<event_grammar>();
+auto const rexpr_array_def = parser::array_def<event_grammar>();
+auto const rexpr_key_value_def = parser::key_value_def<event_grammar>();
+auto const rexpr_inner_def = parser::inner_def<event_grammar>();
+auto const rexpr_def = rexpr_inner_def;
+
+BOOST_SPIRIT_DEFINE(rexpr_value, rexpr_key_value, rexpr_inner, rexpr_array, rexpr,
+                    close_brace, close_bracket)
+
+// Only the outermost rexpr reports errors, as in rexpr_def.hpp
+struct rexpr_class : parser::error_handler_base
+{
+};
+} // namespace grammar
+} // namespace
+
+bool parse_events(char const* first, char const* last, event_handler& handler,
+                  std::ostream& err, std::string const& file)
+{
+    using boost::spirit::x3::with;
+    using boost::spirit::x3::ascii::space;
+    using parser::error_handler_tag;
+
+    parser::pointer_error_handler_type error_handler(first, last, err, file);
+    auto const parser = with<grammar::handler_tag>(std::ref(handler))
+        [with<error_handler_tag>(std::ref(error_handler))[grammar::rexpr]];
+
+    char const* iter = first;
+    if (!phrase_parse(iter, last, parser, space))
+        return false;
+    if (iter != last)
+    {
+        error_handler(iter, "Error! Expecting end of input here: ");
+        return false;
+    }
+    return true;
+}
+
+bool parse_events(char const* first, char const* last, event_handler& handler,
+                  parse_error& error)
+{
+    using boost::spirit::x3::with;
+    using boost::spirit::x3::ascii::space;
+    using parser::error_recorder_tag;
+
+    parser::error_recorder recorder{first, {}};
+    auto const parser = with<grammar::handler_tag>(std::ref(handler))
+        [with<error_recorder_tag>(std::ref(recorder))[grammar::rexpr]];
+
+    char const* iter = first;
+    if (!phrase_parse(iter, last, parser, space))
+    {
+        // Only a missing opening brace fails without an expectation error
+        error = recorder.failed ? recorder.error
+                                : parse_error{static_cast<std::size_t>(iter - first),
+                                              expectation::rexpr};
+        return false;
+    }
+    if (iter != last)
+    {
+        error = {static_cast<std::size_t>(iter - first), expectation::end_of_input};
+        return false;
+    }
+    return true;
+}
+
+bool validate(char const* first, char const* last, parse_error& error)
+{
+    event_handler ignore;
+    return parse_events(first, last, ignore, error);
+}
+} // namespace rexpr
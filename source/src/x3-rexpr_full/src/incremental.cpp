@@ -0,0 +1,143 @@
+#include "rexpr/incremental.hpp"
+#include "rexpr/config.hpp"
+#include "rexpr/rexpr_def.hpp"
+
+#include <algorithm>
+
+namespace rexpr
+{
+namespace
+{
+using parser::pointer_error_handler_type;
+
+template <typename Span>
+void collect(Span& s, ast::rexpr& node, pointer_error_handler_type& error_handler,
+             char const* base)
+{
+    auto const range = error_handler.position_of(node);
+    s.first = static_cast<std::size_t>(range.begin() - base);
+    s.last = static_cast<std::size_t>(range.end() - base);
+    s.node = &node;
+    s.children.clear();
+
+    for (auto& entry : node.entries)
+    {
+        if (auto const child = boost::get<x3::forward_ast<ast::rexpr>>(&entry.second))
+        {
+            s.children.emplace_back();
+            collect(s.children.back(), child->get(), error_handler, base);
+        }
+    }
+    std::sort(s.children.begin(), s.children.end(),
+              [](Span const& a, Span const& b) { return a.first < b.first; });
+}
+
+// Moves the spans behind an edit of [offset, end) that changed the size by delta
+template <typename Span>
+void shift(Span& s, std::size_t end, std::ptrdiff_t delta)
+{
+    if (s.first >= end)
+        s.first = static_cast<std::size_t>(static_cast<std::ptrdiff_t>(s.first) + delta);
+    if (s.last >= end)
+        s.last = static_cast<std::size_t>(static_cast<std::ptrdiff_t>(s.last) + delta);
+    for (auto& child : s.children)
+        shift(child, end, delta);
+}
+} // namespace
+
+incremental_parser::incremental_parser(std::string text, std::ostream& err, std::string file)
+    : text_(std::move(text)), err_(err), file_(std::move(file))
+{
+    ok_ = parse_all();
+}
+
+incremental_parser::reparse incremental_parser::edit(std::size_t offset, std::size_t removed,
+                                                     std::string_view inserted)
+{
+    text_.replace(offset, removed, inserted);
+
+    if (ok_)
+    {
+        std::size_t const end = offset + removed;
+        auto const delta = static_cast<std::ptrdiff_t>(inserted.size()) -
+                           static_cast<std::ptrdiff_t>(removed);
+
+        // The innermost rexpr with the edit strictly between its braces
+        span* block = nullptr;
+        for (span* s = &spans_; s != nullptr && s->first < offset && end < s->last;)
+        {
+            block = s;
+            auto const child = std::find_if(s->children.begin(), s->children.end(),
+                                            [&](span const& c) { return c.last > offset; });
+            s = child != s->children.end() ? &*child : nullptr;
+        }
+
+        if (block != nullptr && block != &spans_)
+        {
+            shift(spans_, end, delta);
+            if (parse_block(*block))
+                return reparse::partial;
+        }
+    }
+
+    ok_ = parse_all();
+    return ok_ ? reparse::full : reparse::failed;
+}
+
+bool incremental_parser::parse_all()
+{
+    using boost::spirit::x3::with;
+    using boost::spirit::x3::ascii::space;
+    using parser::error_handler_tag;
+
+    char const* const first = text_.data();
+    char const* const last = first + text_.size();
+    pointer_error_handler_type error_handler(first, last, err_, file_);
+    auto const parser = with<error_handler_tag>(std::ref(error_handler))[rexpr()];
+
+    reparsed_ = text_.size();
+    ast::rexpr ast;
+    char const* iter = first;
+    if (!phrase_parse(iter, last, parser, space, ast))
+        return false;
+    if (iter != last)
+    {
+        error_handler(iter, "Error! Expecting end of input here: ");
+        return false;
+    }
+
+    root_ = std::move(ast);
+    collect(spans_, root_, error_handler, first);
+    return true;
+}
+
+bool incremental_parser::parse_block(span& block)
+{
+    using boost::spirit::x3::with;
+    using boost::spirit::x3::ascii::space;
+    using parser::error_handler_tag;
+
+    char const* const base = text_.data();
+    char const* iter = base + block.first;
+    char const* const last = base + block.last;
+    pointer_error_handler_type error_handler(base, base + text_.size(), err_, file_);
+    auto const parser = with<error_handler_tag>(std::ref(error_handler))[parser::rexpr_inner];
+
+    reparsed_ = block.last - block.first;
+    ast::rexpr ast;
+    try
+    {
+        // rexpr_inner reports no errors of its own; the full parse will
+        if (!phrase_parse(iter, last, parser, space, ast) || iter != last)
+            return false;
+    }
+    catch (x3::expectation_failure<char const*> const&)
+    {
+        return false;
+    }
+
+    *block.node = std::move(ast);
+    collect(block, *block.node, error_handler, base);
+    return true;
+}
+} // namespace rexpr
@@ -0,0 +1,225 @@
+#include "rexpr/parallel.hpp"
+#include "rexpr/config.hpp"
+#include "rexpr/rexpr_def.hpp"
+
+#include "io/swar.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <streambuf>
+#include <thread>
+
+namespace rexpr
+{
+namespace
+{
+///////////////////////////////////////////////////////////////////////////
+//  Structural scan
+///////////////////////////////////////////////////////////////////////////
+bool is_structural(char c)
+{
+    return c == '"' || c == '{' || c == '}' || c == '[' || c == ']';
+}
+
+// The next '"', '{', '}', '[' or ']' at or after p, eight bytes at a time
+char const* find_structural(char const* p, char const* last)
+{
+    using namespace io::swar;
+
+    while (last - p >= 8)
+    {
+        std::uint64_t const word = load_word(p);
+        // '[' and ']' differ from '{' and '}' only in bit 5
+        std::uint64_t const folded = word | (low_bits * 0x20);
+        if (match_byte(word, '"') | match_byte(folded, '{') | match_byte(folded, '}'))
+            break;
+        p += 8;
+    }
+    while (p != last && !is_structural(*p))
+        ++p;
+    return p;
+}
+
+///////////////////////////////////////////////////////////////////////////
+//  The top-level entries of a chunk, as in rexpr_inner_def
+///////////////////////////////////////////////////////////////////////////
+struct entries_class;
+x3::rule<entries_class, ast::rexpr_map> const entries = "entries";
+auto const entries_def = *parser::rexpr_key_value;
+BOOST_SPIRIT_DEFINE(entries)
+
+class null_buffer : public std::streambuf
+{
+protected:
+    int overflow(int c) override { return c; }
+};
+
+bool parse_chunk(char const* first, char const* last, char const* chunk_first,
+                 char const* chunk_last, ast::rexpr_map& result)
+{
+    using boost::spirit::x3::with;
+    using boost::spirit::x3::ascii::space;
+    using parser::error_handler_tag;
+
+    // Errors are reported by the serial parse that follows a failure
+    null_buffer discard;
+    std::ostream err(&discard);
+    parser::pointer_error_handler_type error_handler(first, last, err);
+    auto const parser = with<error_handler_tag>(std::ref(error_handler))[entries];
+
+    try
+    {
+        char const* iter = chunk_first;
+        return phrase_parse(iter, chunk_last, parser, space, result) && iter == chunk_last;
+    }
+    catch (x3::expectation_failure<char const*> const&)
+    {
+        return false;
+    }
+}
+
+std::optional<ast::rexpr> parse_serial(char const* first, char const* last, std::ostream& err,
+                                       std::string const& file)
+{
+    using boost::spirit::x3::with;
+    using boost::spirit::x3::ascii::space;
+    using parser::error_handler_tag;
+
+    parser::pointer_error_handler_type error_handler(first, last, err, file);
+    auto const parser = with<error_handler_tag>(std::ref(error_handler))[rexpr()];
+
+    ast::rexpr ast;
+    char const* iter = first;
+    if (!phrase_parse(iter, last, parser, space, ast))
+        return std::nullopt;
+    if (iter != last)
+    {
+        error_handler(iter, "Error! Expecting end of input here: ");
+        return std::nullopt;
+    }
+    return ast;
+}
+} // namespace
+
+std::vector<char const*> scan_entries(char const* first, char const* last)
+{
+    std::vector<char const*> starts;
+    char const* p = first;
+    while (p != last && std::isspace(static_cast<unsigned char>(*p)))
+        ++p;
+    if (p == last || *p != '{')
+        return starts;
+
+    auto const skip_space = [last](char const* q) {
+        while (q != last && std::isspace(static_cast<unsigned char>(*q)))
+            ++q;
+        return q;
+    };
+
+    std::size_t depth = 1;
+    for (p = find_structural(p + 1, last); p != last; p = find_structural(p + 1, last))
+    {
+        if (*p == '"')
+        {
+            // Values are handled right after their key, so at depth 1 every
+            // string is a key
+            bool const is_key = depth == 1;
+            if (is_key)
+                starts.push_back(p);
+            // Strings cannot contain quotes, so the next one closes it
+            auto rest = static_cast<std::size_t>(last - p - 1);
+            p = static_cast<char const*>(std::memchr(p + 1, '"', rest));
+            if (p == nullptr)
+                break;
+            if (!is_key)
+                continue;
+
+            char const* v = skip_space(p + 1);
+            if (v == last || *v != '=')
+                break;
+            v = skip_space(v + 1);
+            if (v == last)
+                break;
+            if (*v == '"')
+            {
+                rest = static_cast<std::size_t>(last - v - 1);
+                p = static_cast<char const*>(std::memchr(v + 1, '"', rest));
+                if (p == nullptr)
+                    break;
+            }
+            else if (*v == '{' || *v == '[')
+            {
+                ++depth;
+                p = v;
+            }
+            // Numbers and booleans hold no structural characters to skip
+        }
+        else if (*p == '{' || *p == '[')
+        {
+            ++depth;
+        }
+        else if (--depth == 0)
+        {
+            if (*p != '}')
+                break;
+            starts.push_back(p);
+            return starts;
+        }
+    }
+    return {};
+}
+
+std::optional<ast::rexpr> parse_parallel(char const* first, char const* last, std::ostream& err,
+                                         unsigned threads, std::string const& file)
+{
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+
+    auto const starts = scan_entries(first, last);
+    if (threads == 1 || starts.size() < 2 * threads)
+        return parse_serial(first, last, err, file);
+
+    // Cut the entries into chunks of about the same number of bytes
+    std::vector<char const*> cuts{starts.front()};
+    std::size_t const total = static_cast<std::size_t>(starts.back() - starts.front());
+    for (auto s = starts.begin() + 1; s != starts.end() - 1; ++s)
+    {
+        std::size_t const done = static_cast<std::size_t>(*s - starts.front());
+        if (done * threads >= total * cuts.size())
+            cuts.push_back(*s);
+    }
+    cuts.push_back(starts.back());
+
+    std::size_t const chunks = cuts.size() - 1;
+    std::vector<ast::rexpr_map> maps(chunks);
+    std::vector<char> ok(chunks, 0);
+    {
+        std::vector<std::thread> workers;
+        workers.reserve(chunks);
+        for (std::size_t i = 0; i < chunks; ++i)
+        {
+            workers.emplace_back([&, i] {
+                ok[i] = parse_chunk(first, last, cuts[i], cuts[i + 1], maps[i]);
+            });
+        }
+        for (auto& worker : workers)
+            worker.join();
+    }
+
+    char const* tail = starts.back() + 1;
+    while (tail != last && std::isspace(static_cast<unsigned char>(*tail)))
+        ++tail;
+    if (tail != last || std::find(ok.begin(), ok.end(), 0) != ok.end())
+        return parse_serial(first, last, err, file);
+
+    // Like the serial parser, keep the first of duplicate keys
+    ast::rexpr result;
+    result.entries = std::move(maps.front());
+    for (std::size_t i = 1; i < chunks; ++i)
+        result.entries.merge(maps[i]);
+    return result;
+}
+} // namespace rexpr
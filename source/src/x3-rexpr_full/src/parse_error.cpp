@@ -0,0 +1,17 @@
+#include "rexpr/parse_error.hpp"
+#include "rexpr/config.hpp"
+
+namespace rexpr
+{
+void report(std::ostream& err, char const* first, char const* last,
+            parse_error const& error, std::string const& file)
+{
+    parser::pointer_error_handler_type error_handler(first, last, err, file);
+    char const* const where = first + error.offset;
+    if (error.expected == expectation::end_of_input)
+        error_handler(where, "Error! Expecting end of input here: ");
+    else
+        error_handler(where,
+                      "Error! Expecting: " + std::string(describe(error.expected)) + " here:");
+}
+} // namespace rexpr
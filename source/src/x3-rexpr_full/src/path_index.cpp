@@ -0,0 +1,128 @@
+#include "rexpr/path_index.hpp"
+
+#include <limits>
+#include <stdexcept>
+
+namespace rexpr
+{
+namespace
+{
+// FNV-1a; keys cannot contain '"', so the encoding is unambiguous
+std::uint64_t hash_bytes(std::string_view bytes)
+{
+    std::uint64_t h = 14695981039346656037ull;
+    for (char c : bytes)
+    {
+        h ^= static_cast<unsigned char>(c);
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+std::size_t count_values(ast::rexpr const& node)
+{
+    std::size_t n = node.entries.size();
+    for (auto const& entry : node.entries)
+    {
+        if (auto const child = boost::get<ast::x3::forward_ast<ast::rexpr>>(&entry.second))
+            n += count_values(child->get());
+    }
+    return n;
+}
+
+// slots store key offsets and sizes in 32 bits
+void check_key_bytes(std::size_t n)
+{
+    if (n > std::numeric_limits<std::uint32_t>::max())
+        throw std::length_error("rexpr::path_index: keys exceed 4 GB");
+}
+
+// '"' ends each key in an encoded path; the rexpr grammar never puts it in one
+void check_key(std::string_view key)
+{
+    if (key.find('"') != std::string_view::npos)
+        throw std::invalid_argument("rexpr::path_index: key contains '\"'");
+}
+} // namespace
+
+path_index::path::path(std::initializer_list<std::string_view> keys)
+{
+    for (auto key : keys)
+        append(key);
+    hash_ = hash_bytes(encoded_);
+}
+
+path_index::path::path(std::vector<std::string> const& keys)
+{
+    for (auto const& key : keys)
+        append(key);
+    hash_ = hash_bytes(encoded_);
+}
+
+void path_index::path::append(std::string_view key)
+{
+    check_key(key);
+    encoded_.append(key);
+    encoded_.push_back('"');
+}
+
+path_index::path_index(ast::rexpr const& root)
+{
+    std::size_t capacity = 16;
+    while (capacity < 2 * count_values(root))
+        capacity *= 2;
+    slots_.resize(capacity);
+
+    std::string prefix;
+    add(root, prefix);
+}
+
+void path_index::add(ast::rexpr const& node, std::string& prefix)
+{
+    for (auto const& entry : node.entries)
+    {
+        check_key(entry.first);
+        auto const length = prefix.size();
+        prefix.append(entry.first);
+        prefix.push_back('"');
+
+        insert(prefix, hash_bytes(prefix), entry.second);
+        if (auto const child = boost::get<ast::x3::forward_ast<ast::rexpr>>(&entry.second))
+            add(child->get(), prefix);
+
+        prefix.resize(length);
+    }
+}
+
+void path_index::insert(std::string_view key, std::uint64_t hash,
+                        ast::rexpr_value const& value)
+{
+    check_key_bytes(keys_.size() + key.size());
+
+    std::size_t const mask = slots_.size() - 1;
+    std::size_t i = static_cast<std::size_t>(hash) & mask;
+    while (slots_[i].value != nullptr)
+        i = (i + 1) & mask;
+
+    slots_[i].hash = hash;
+    slots_[i].key_offset = static_cast<std::uint32_t>(keys_.size());
+    slots_[i].key_size = static_cast<std::uint32_t>(key.size());
+    slots_[i].value = &value;
+    keys_.append(key);
+    ++size_;
+}
+
+ast::rexpr_value const* path_index::find(path const& p) const
+{
+    std::size_t const mask = slots_.size() - 1;
+    for (std::size_t i = static_cast<std::size_t>(p.hash_) & mask; slots_[i].value != nullptr;
+         i = (i + 1) & mask)
+    {
+        slot const& s = slots_[i];
+        if (s.hash == p.hash_ &&
+            std::string_view(keys_).substr(s.key_offset, s.key_size) == p.encoded_)
+            return s.value;
+    }
+    return nullptr;
+}
+} // namespace rexpr
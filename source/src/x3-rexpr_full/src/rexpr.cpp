@@ -10,4 +10,13 @@
 namespace rexpr::parser
 {
 BOOST_SPIRIT_INSTANTIATE(rexpr_type, iterator_type, context_type)
+BOOST_SPIRIT_INSTANTIATE(rexpr_type, pointer_iterator_type, pointer_context_type)
 }
+
+namespace rexpr
+{
+parser::rexpr_type const& rexpr()
+{
+    return parser::rexpr;
+}
+} // namespace rexpr
@@ -0,0 +1,164 @@
+#include "rexpr/serializer.hpp"
+#include "rexpr/printer.hpp"
+
+#include <cerrno>
+#include <charconv>
+#include <system_error>
+
+#include <unistd.h>
+
+namespace rexpr
+{
+namespace
+{
+std::size_t const tabsize = 4;
+}
+
+serializer::serializer(layout l) : layout_(l)
+{
+}
+
+serializer::serializer(int fd, layout l, std::size_t flush_at)
+    : layout_(l), fd_(fd), flush_at_(flush_at)
+{
+    buffer_.reserve(flush_at);
+}
+
+serializer::~serializer()
+{
+    try
+    {
+        flush();
+    }
+    catch (std::system_error const&)
+    {
+        // nowhere to report it; call flush() first to find out
+    }
+}
+
+void serializer::write(ast::rexpr const& r)
+{
+    write(r, 0);
+    buffer_ += '\n';
+    if (fd_ >= 0 && buffer_.size() >= flush_at_)
+        flush();
+}
+
+void serializer::flush()
+{
+    if (fd_ < 0)
+        return;
+
+    char const* p = buffer_.data();
+    std::size_t left = buffer_.size();
+    while (left != 0)
+    {
+        auto const n = ::write(fd_, p, left);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            throw std::system_error(errno, std::generic_category(), "rexpr::serializer");
+        }
+        p += n;
+        left -= static_cast<std::size_t>(n);
+    }
+    buffer_.clear();
+}
+
+void serializer::write(ast::rexpr const& r, std::size_t indent)
+{
+    bool const pretty = layout_ == layout::pretty;
+
+    buffer_ += '{';
+    for (auto const& entry : r.entries)
+    {
+        if (pretty)
+        {
+            buffer_ += '\n';
+            buffer_.append(indent + tabsize, ' ');
+        }
+        write_quoted(entry.first);
+        buffer_.append(pretty ? " = " : "=");
+
+        write(entry.second, indent + tabsize);
+
+        // Flush in the middle of large documents, too
+        if (fd_ >= 0 && buffer_.size() >= flush_at_)
+            flush();
+    }
+    if (pretty)
+    {
+        buffer_ += '\n';
+        buffer_.append(indent, ' ');
+    }
+    buffer_ += '}';
+}
+
+void serializer::write(ast::rexpr_value const& value, std::size_t indent)
+{
+    using ast::x3::forward_ast;
+
+    if (auto const text = boost::get<std::string>(&value))
+        write_quoted(*text);
+    else if (auto const integer = boost::get<std::int64_t>(&value))
+    {
+        char digits[20]; // "-9223372036854775808"
+        auto const end = std::to_chars(digits, digits + sizeof digits, *integer).ptr;
+        buffer_.append(digits, end);
+    }
+    else if (auto const real = boost::get<double>(&value))
+    {
+        char digits[ast::max_real_chars];
+        buffer_.append(digits, ast::format_real(*real, digits));
+    }
+    else if (auto const boolean = boost::get<bool>(&value))
+        buffer_.append(*boolean ? "true" : "false");
+    else if (auto const child = boost::get<forward_ast<ast::rexpr>>(&value))
+        write(child->get(), indent);
+    else
+        write(boost::get<forward_ast<ast::rexpr_array>>(value).get(), indent);
+}
+
+void serializer::write(ast::rexpr_array const& a, std::size_t indent)
+{
+    bool const pretty = layout_ == layout::pretty;
+
+    buffer_ += '[';
+    bool first = true;
+    for (auto const& element : a.elements)
+    {
+        if (pretty)
+        {
+            buffer_ += '\n';
+            buffer_.append(indent + tabsize, ' ');
+        }
+        else if (!first)
+        {
+            buffer_ += ' ';
+        }
+        write(element, indent + tabsize);
+        first = false;
+    }
+    if (pretty)
+    {
+        buffer_ += '\n';
+        buffer_.append(indent, ' ');
+    }
+    buffer_ += ']';
+}
+
+void serializer::write_quoted(std::string const& text)
+{
+    buffer_ += '"';
+    buffer_.append(text);
+    buffer_ += '"';
+}
+
+std::string to_string(ast::rexpr const& r, layout l)
+{
+    serializer s(l);
+    s.write(r);
+    return std::string(s.buffer());
+}
+} // namespace rexpr
@@ -0,0 +1,201 @@
+#include "rexpr/binary.hpp"
+#include "rexpr/bulk.hpp"
+#include "rexpr/printer.hpp"
+
+#include <catch.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+std::string const example = R"({
+    "color" = "blue"
+    "empty" = {}
+    "position" = {
+        "x" = "123"
+        "y" = { "z" = "" }
+    }
+    "size" = "29 cm."
+})";
+
+std::string const typed = R"({
+    "count" = -42
+    "flags" = [true false]
+    "matrix" = [[1 2] [] [3.5 "x"]]
+    "points" = [{ "x" = 1 } { "x" = 2 "x" = 3 }]
+    "scale" = 1e3
+})";
+
+rexpr::ast::rexpr parse(std::string const& text)
+{
+    rexpr::ast::rexpr result;
+    std::ostringstream err;
+    rexpr::parse_all(text.data(), text.data() + text.size(),
+                     [&](rexpr::ast::rexpr&& r) { result = std::move(r); }, err);
+    return result;
+}
+
+std::string print(rexpr::ast::rexpr const& r)
+{
+    std::ostringstream out;
+    rexpr::ast::rexpr_printer{out}(r);
+    return out.str();
+}
+} // namespace
+
+TEST_CASE("binary rexprs are navigated in place", "[binary]")
+{
+    std::string const bytes = rexpr::binary::compile(parse(example));
+    auto const root = rexpr::binary::root(bytes);
+
+    REQUIRE(root.size() == 4);
+    CHECK(root.key(0) == "color");
+    CHECK(root.at(0).text() == "blue");
+    CHECK(root.at(0).text().data() >= bytes.data());
+
+    auto const position = root.find("position");
+    REQUIRE(position);
+    REQUIRE(position->is_rexpr());
+    auto const y = position->rexpr().find("y");
+    REQUIRE(y);
+    auto const z = y->rexpr().find("z");
+    REQUIRE(z);
+    CHECK_FALSE(z->is_rexpr());
+    CHECK(z->text().empty());
+
+    CHECK(root.find("empty")->rexpr().size() == 0);
+    CHECK_FALSE(root.find("missing"));
+    CHECK_FALSE(root.find(""));
+    CHECK_FALSE(root.find("zzz"));
+}
+
+TEST_CASE("binary rexprs round-trip to text", "[binary]")
+{
+    auto const ast = parse(example);
+    std::string const bytes = rexpr::binary::compile(ast);
+    CHECK(print(rexpr::binary::to_ast(rexpr::binary::root(bytes))) == print(ast));
+}
+
+TEST_CASE("binary rexprs hold typed values and arrays", "[binary]")
+{
+    auto const ast = parse(typed);
+    std::string const bytes = rexpr::binary::compile(ast);
+    auto const root = rexpr::binary::root(bytes);
+
+    auto const count = root.find("count");
+    REQUIRE(count);
+    REQUIRE(count->is_integer());
+    CHECK(count->as_integer() == -42);
+    CHECK(root.find("scale")->as_real() == Approx(1000.0));
+
+    auto const flags = root.find("flags");
+    REQUIRE(flags);
+    REQUIRE(flags->is_array());
+    REQUIRE(flags->array().size() == 2);
+    CHECK(flags->array().at(0).as_boolean());
+    CHECK_FALSE(flags->array().at(1).as_boolean());
+
+    auto const matrix = root.find("matrix")->array();
+    REQUIRE(matrix.size() == 3);
+    CHECK(matrix.at(1).array().size() == 0);
+    CHECK(matrix.at(2).array().at(1).text() == "x");
+
+    CHECK(print(rexpr::binary::to_ast(root)) == print(ast));
+}
+
+TEST_CASE("binary rexprs are read from mapped files", "[binary]")
+{
+    std::string const path = "rexpr_binary_test.rexb";
+    {
+        std::string const bytes = rexpr::binary::compile(parse(example));
+        std::ofstream out(path, std::ios::binary);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+    {
+        rexpr::binary::file const file(path);
+        auto const size = file.root().find("size");
+        REQUIRE(size);
+        CHECK(size->text() == "29 cm.");
+    }
+    std::remove(path.c_str());
+}
+
+TEST_CASE("binary root rejects other data", "[binary]")
+{
+    CHECK_THROWS_AS(rexpr::binary::root(""), std::runtime_error);
+    CHECK_THROWS_AS(rexpr::binary::root(example), std::runtime_error);
+
+    std::string bytes = rexpr::binary::compile(parse(example));
+    bytes[4] = 9;
+    CHECK_THROWS_AS(rexpr::binary::root(bytes), std::runtime_error);
+}
+
+TEST_CASE("truncated binary rexprs throw instead of reading past the end", "[binary]")
+{
+    std::string const bytes = rexpr::binary::compile(parse(typed));
+    for (std::size_t size = 0; size < bytes.size(); ++size)
+    {
+        INFO(size);
+        // A copy of exactly `size` bytes, so that reads past it are caught by
+        // sanitizers too
+        std::string const truncated = bytes.substr(0, size);
+        CHECK_THROWS_AS(rexpr::binary::to_ast(rexpr::binary::root(truncated)),
+                        std::runtime_error);
+    }
+}
+
+TEST_CASE("corrupt offsets and sizes in binary rexprs throw", "[binary]")
+{
+    std::string const bytes = rexpr::binary::compile(parse(typed));
+    std::uint32_t const huge = 0x7ffffff0;
+
+    std::size_t thrown = 0;
+    for (std::size_t at = 16; at + 4 <= bytes.size(); at += 4)
+    {
+        std::string corrupt = bytes;
+        std::memcpy(&corrupt[at], &huge, sizeof huge);
+        try
+        {
+            rexpr::binary::to_ast(rexpr::binary::root(corrupt));
+        }
+        catch (std::runtime_error const&)
+        {
+            ++thrown;
+        }
+    }
+    CHECK(thrown > 0);
+
+    auto const root = rexpr::binary::root(bytes);
+    CHECK_THROWS_AS(root.at(root.size()), std::out_of_range);
+    CHECK_THROWS_AS(root.key(root.size()), std::out_of_range);
+    CHECK_THROWS_AS(root.find("flags")->array().at(2), std::out_of_range);
+}
+
+TEST_CASE("binary nodes and arrays that point back at themselves throw", "[binary]")
+{
+    auto const load = [](std::string const& bytes, std::size_t at) {
+        std::uint32_t v;
+        std::memcpy(&v, &bytes[at], sizeof v);
+        return v;
+    };
+
+    // The root's only entry points its value at the root
+    std::string node = rexpr::binary::compile(parse(R"({ "a" = {} })"));
+    std::uint32_t const root = load(node, 12);
+    std::memcpy(&node[root + 4 + 8], &root, sizeof root);
+    CHECK_THROWS_AS(rexpr::binary::to_ast(rexpr::binary::root(node)), std::runtime_error);
+    CHECK_THROWS_AS(rexpr::binary::root(node).at(0), std::runtime_error);
+
+    // The array's only element points at the array
+    std::string array = rexpr::binary::compile(parse(R"({ "a" = [[]] })"));
+    std::uint32_t const outer = load(array, load(array, 12) + 4 + 8);
+    std::memcpy(&array[outer + 4], &outer, sizeof outer);
+    CHECK_THROWS_AS(rexpr::binary::to_ast(rexpr::binary::root(array)),
+                    std::runtime_error);
+    CHECK_THROWS_AS(rexpr::binary::root(array).at(0).array().at(0), std::runtime_error);
+}
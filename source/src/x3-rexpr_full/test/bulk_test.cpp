@@ -0,0 +1,86 @@
+#include "rexpr/bulk.hpp"
+#include "rexpr/mapped_file.hpp"
+
+#include <catch.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace
+{
+rexpr::bulk_result parse_string(std::string const& text, std::vector<rexpr::ast::rexpr>& out,
+                                std::ostream& err)
+{
+    return rexpr::parse_all(text.data(), text.data() + text.size(),
+                            [&](rexpr::ast::rexpr&& r) { out.push_back(std::move(r)); }, err);
+}
+} // namespace
+
+TEST_CASE("parse_all hands over every top-level rexpr", "[bulk]")
+{
+    std::string const text = "\n{ \"a\" = \"1\" }\n{ \"b\" = { \"c\" = \"2\" } }  \n{}\n";
+    std::vector<rexpr::ast::rexpr> parsed;
+    std::ostringstream err;
+
+    auto const result = parse_string(text, parsed, err);
+
+    REQUIRE(result.ok);
+    REQUIRE(result.count == 3);
+    REQUIRE(parsed.size() == 3);
+    CHECK(boost::get<std::string>(parsed[0].entries.at("a")) == "1");
+    auto const& b = boost::get<boost::spirit::x3::forward_ast<rexpr::ast::rexpr>>(parsed[1].entries.at("b")).get();
+    CHECK(boost::get<std::string>(b.entries.at("c")) == "2");
+    CHECK(parsed[2].entries.empty());
+    CHECK(err.str().empty());
+}
+
+TEST_CASE("parse_all accepts empty and blank input", "[bulk]")
+{
+    std::vector<rexpr::ast::rexpr> parsed;
+    std::ostringstream err;
+
+    CHECK(parse_string("", parsed, err).count == 0);
+    CHECK(parse_string(" \n\t ", parsed, err).ok);
+    CHECK(parsed.empty());
+}
+
+TEST_CASE("parse_all stops at the first malformed rexpr", "[bulk]")
+{
+    std::string const text = "{ \"a\" = \"1\" }\n{ \"b\" \"2\" }\n{ \"c\" = \"3\" }";
+    std::vector<rexpr::ast::rexpr> parsed;
+    std::ostringstream err;
+
+    auto const result = parse_string(text, parsed, err);
+
+    CHECK_FALSE(result.ok);
+    CHECK(result.count == 1);
+    CHECK(result.error_offset == text.find("{ \"b\""));
+    CHECK(parsed.size() == 1);
+    CHECK(err.str().find("line 2") != std::string::npos);
+}
+
+TEST_CASE("mapped_file exposes the file contents", "[bulk]")
+{
+    std::string const path = "rexpr_bulk_test.input";
+    {
+        std::ofstream file(path);
+        file << "{ \"x\" = \"1\" }\n{ \"y\" = \"2\" }\n";
+    }
+
+    {
+        rexpr::mapped_file const file(path);
+        std::ostringstream err;
+        std::size_t count = 0;
+        auto const result = rexpr::parse_all(
+            file.begin(), file.end(), [&](rexpr::ast::rexpr&&) { ++count; }, err, path);
+        CHECK(result.ok);
+        CHECK(count == 2);
+    }
+    std::remove(path.c_str());
+
+    CHECK_THROWS_AS(rexpr::mapped_file("no/such/file.rexpr"), std::system_error);
+}
@@ -0,0 +1,133 @@
+#include "rexpr/bulk.hpp"
+#include "rexpr/document.hpp"
+#include "rexpr/printer.hpp"
+
+#include <catch.hpp>
+
+#include <sstream>
+#include <string>
+
+namespace
+{
+std::string const example = R"({
+    "color" = "blue"
+    "size" = "29 cm."
+    "position" = {
+        "x" = "123"
+        "y" = "456"
+    }
+    "color" = "red"
+})";
+
+std::string const typed = R"({
+    "count" = -42
+    "flags" = [true false]
+    "matrix" = [[1 2] [] [3.5 "x"]]
+    "points" = [{ "x" = 1 } { "x" = 2 "x" = 3 }]
+    "scale" = 1e3
+})";
+
+std::string print_ast(std::string const& text)
+{
+    std::ostringstream out;
+    rexpr::parse_all(text.data(), text.data() + text.size(),
+                     [&](rexpr::ast::rexpr&& r) { rexpr::ast::rexpr_printer{out}(r); }, out);
+    return out.str();
+}
+
+std::string print_document(std::string const& text)
+{
+    std::ostringstream out;
+    if (auto const doc = rexpr::flat::parse_document(std::string_view(text), out))
+        rexpr::flat::print(out, *doc);
+    return out.str();
+}
+} // namespace
+
+TEST_CASE("document prints like the owning AST", "[document]")
+{
+    CHECK(print_document(example) == print_ast(example));
+    CHECK(print_document("{}") == print_ast("{}"));
+    CHECK(print_document(typed) == print_ast(typed));
+}
+
+TEST_CASE("document views point into the source", "[document]")
+{
+    std::ostringstream err;
+    auto const doc = rexpr::flat::parse_document(std::string_view(example), err);
+    REQUIRE(doc);
+    CHECK(doc->node_count() == 2);
+    CHECK(doc->entry_count() == 5);
+
+    auto const& root = doc->root();
+    auto const color = doc->find(root, "color");
+    REQUIRE(color);
+    CHECK(color->text == "blue");
+    CHECK(color->text.data() == example.data() + example.find("blue"));
+
+    auto const position = doc->find(root, "position");
+    REQUIRE(position);
+    REQUIRE(position->is_rexpr());
+    auto const y = doc->find(doc->child(*position), "y");
+    REQUIRE(y);
+    CHECK(y->text == "456");
+
+    CHECK(doc->find(root, "x") == nullptr);
+    CHECK(doc->find(root, "") == nullptr);
+}
+
+TEST_CASE("document holds typed values and ordered arrays", "[document]")
+{
+    using rexpr::flat::kind;
+
+    std::ostringstream err;
+    auto const doc = rexpr::flat::parse_document(std::string_view(typed), err);
+    REQUIRE(doc);
+    auto const& root = doc->root();
+
+    auto const count = doc->find(root, "count");
+    REQUIRE(count);
+    CHECK(count->type == kind::integer);
+    CHECK(count->integer == -42);
+    CHECK(doc->find(root, "scale")->real == Approx(1000.0));
+
+    auto const matrix = doc->find(root, "matrix");
+    REQUIRE(matrix);
+    REQUIRE(matrix->is_array());
+    auto const& rows = doc->child(*matrix);
+    REQUIRE(rows.size == 3);
+    auto const row = doc->begin(rows);
+    CHECK(doc->child(row[1].val).size == 0);
+    auto const last = doc->begin(doc->child(row[2].val));
+    CHECK(last[0].val.type == kind::real);
+    CHECK(last[1].val.text == "x");
+
+    auto const points = doc->begin(doc->child(*doc->find(root, "points")));
+    REQUIRE(points[1].val.is_rexpr());
+    CHECK(doc->find(doc->child(points[1].val), "x")->integer == 2);
+}
+
+TEST_CASE("document keeps a shared source alive", "[document]")
+{
+    std::ostringstream err;
+    std::optional<rexpr::flat::document> doc;
+    {
+        auto source = std::make_shared<std::string const>(example);
+        doc = rexpr::flat::parse_document(std::move(source), err);
+    }
+    REQUIRE(doc);
+    auto const size = doc->find(doc->root(), "size");
+    REQUIRE(size);
+    CHECK(size->text == "29 cm.");
+}
+
+TEST_CASE("document reports errors like the rexpr parser", "[document]")
+{
+    std::string const missing_value = "{\n    \"position\" = $\n}";
+    std::string const missing_equals = "{\n    \"x\" : \"123\"\n}";
+    std::string const trailing = "{\n}\n;";
+
+    CHECK(print_document(missing_value) == print_ast(missing_value));
+    CHECK(print_document(missing_equals) == print_ast(missing_equals));
+    CHECK(print_document(trailing).find("Expecting end of input") != std::string::npos);
+}
@@ -0,0 +1,184 @@
+#include "rexpr/events.hpp"
+#include "rexpr/incremental.hpp"
+#include "rexpr/printer.hpp"
+
+#include <catch.hpp>
+
+#include <sstream>
+#include <string>
+
+namespace
+{
+class recorder : public rexpr::event_handler
+{
+public:
+    void begin_map() override { log += "{ "; }
+    void key(std::string_view k) override { log += std::string(k) + "="; }
+    void string_value(std::string_view text) override { log += "'" + std::string(text) + "' "; }
+    void integer_value(std::int64_t v) override { log += std::to_string(v) + " "; }
+    void real_value(double v) override { log += rexpr::ast::format_real(v) + " "; }
+    void bool_value(bool v) override { log += v ? "true " : "false "; }
+    void end_map() override { log += "} "; }
+    void begin_array() override { log += "[ "; }
+    void end_array() override { log += "] "; }
+
+    std::string log;
+};
+
+class key_counter : public rexpr::event_handler
+{
+public:
+    void key(std::string_view) override { ++keys; }
+
+    int keys = 0;
+};
+
+bool parse(std::string const& text, rexpr::event_handler& handler, std::string& errors)
+{
+    std::ostringstream err;
+    bool const ok =
+        rexpr::parse_events(text.data(), text.data() + text.size(), handler, err, "input");
+    errors = err.str();
+    return ok;
+}
+
+// The AST parser's verdict on text, as parse_events reaches its own
+bool parse_ast(std::string const& text, std::string& errors)
+{
+    std::ostringstream err;
+    rexpr::incremental_parser const document(text, err, "input");
+    errors = err.str();
+    return document.ok();
+}
+
+// The recorded error of validate, reported lazily
+std::string validate(std::string const& text, rexpr::parse_error& error)
+{
+    std::ostringstream err;
+    if (!rexpr::validate(text.data(), text.data() + text.size(), error))
+        rexpr::report(err, text.data(), text.data() + text.size(), error, "input");
+    return err.str();
+}
+} // namespace
+
+TEST_CASE("events follow the document in source order", "[events]")
+{
+    recorder r;
+    std::string errors;
+    REQUIRE(parse(R"({
+        "color" = "blue"
+        "position" = { "x" = "1" "y" = {} }
+        "color" = ""
+    })",
+                  r, errors));
+    CHECK(r.log == "{ color='blue' position={ x='1' y={ } } color='' } ");
+    CHECK(errors.empty());
+}
+
+TEST_CASE("events report typed values and arrays", "[events]")
+{
+    recorder r;
+    std::string errors;
+    REQUIRE(parse(R"({ "a" = [1 -2.5 true [] { "b" = "c" }] "d" = 1e3 })", r, errors));
+    CHECK(r.log == "{ a=[ 1 -2.5 true [ ] { b='c' } ] d=1000.0 } ");
+}
+
+TEST_CASE("handlers only override the events they need", "[events]")
+{
+    key_counter counter;
+    std::string errors;
+    REQUIRE(parse("{ \"a\" = \"1\" \"b\" = { \"c\" = \"2\" } }", counter, errors));
+    CHECK(counter.keys == 3);
+}
+
+TEST_CASE("event parsing reports errors like the rexpr parser", "[events]")
+{
+    recorder r;
+    std::string errors;
+
+    CHECK_FALSE(parse("{\n    \"position\" = $\n}", r, errors));
+    CHECK(errors.find("line 2") != std::string::npos);
+    CHECK(errors.find("Expecting: Value") != std::string::npos);
+
+    CHECK_FALSE(parse("{} ;", r, errors));
+    CHECK(errors.find("Expecting end of input") != std::string::npos);
+}
+
+TEST_CASE("validation records errors for a lazy report", "[events]")
+{
+    using rexpr::expectation;
+
+    std::string const missing_value = "{\n    \"position\" = $\n}";
+    std::string const missing_equals = "{ \"a\" = [1 2] \"b\" \"c\" }";
+    std::string const open_array = "{ \"a\" = [1 2 }";
+    std::string const trailing = "{} ;";
+
+    struct
+    {
+        std::string const& text;
+        std::size_t offset;
+        expectation expected;
+    } const cases[] = {
+        {missing_value, missing_value.find('$'), expectation::value},
+        {missing_equals, missing_equals.find("\"c\""), expectation::equals},
+        {open_array, open_array.find('}'), expectation::close_bracket},
+        {trailing, trailing.find(';'), expectation::end_of_input},
+    };
+    for (auto const& c : cases)
+    {
+        rexpr::parse_error error;
+        recorder r;
+        std::string errors;
+        std::string const report = validate(c.text, error);
+        CHECK(error.offset == c.offset);
+        CHECK(error.expected == c.expected);
+        CHECK_FALSE(parse(c.text, r, errors));
+        CHECK(report == errors);
+    }
+
+    rexpr::parse_error error;
+    CHECK(validate("{ \"a\" = { \"b\" = [true 1.5] } }", error).empty());
+    CHECK(validate("  nope", error).find("Expecting: RExpression") != std::string::npos);
+    CHECK(error.offset == 2);
+}
+
+TEST_CASE("the event and AST parsers accept and reject the same documents", "[events]")
+{
+    char const* const corpus[] = {
+        "{}",
+        R"({ "a" = "1" "b" = { "c" = [1 -2.5 true [] {}] } })",
+        R"({ "a" = 1e3 "b" = false "c" = "" })",
+        "\n  {\n \"a\" = [ ] }  \n",
+        "",
+        "  nope",
+        "{",
+        "{ \"a\" }",
+        "{ \"a\" = }",
+        "{ \"a\" = $ }",
+        "{ \"a\" = [1 2 }",
+        "{ \"a\" = { \"b\" = 1 }",
+        "{ \"a\" = \"1\" \"b\" \"2\" }",
+        "{ a = 1 }",
+        "{ \"a\" = [1, 2] }",
+        "{ \"a\" = \"unterminated }",
+        "{} {}",
+        "{} ;",
+    };
+    for (char const* text : corpus)
+    {
+        INFO(text);
+        recorder r;
+        std::string ast_errors;
+        std::string event_errors;
+        bool const ast_ok = parse_ast(text, ast_errors);
+        CHECK(parse(text, r, event_errors) == ast_ok);
+        CHECK(event_errors == ast_errors);
+
+        // Recorded errors carry the same offset and expectation
+        rexpr::parse_error error;
+        std::string const report = validate(text, error);
+        CHECK(report.empty() == ast_ok);
+        if (!ast_errors.empty())
+            CHECK(report == ast_errors);
+    }
+}
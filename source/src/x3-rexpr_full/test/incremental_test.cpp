@@ -0,0 +1,106 @@
+#include "rexpr/incremental.hpp"
+#include "rexpr/printer.hpp"
+
+#include <catch.hpp>
+
+#include <sstream>
+#include <string>
+
+namespace
+{
+using reparse = rexpr::incremental_parser::reparse;
+
+std::string const example = R"({
+    "color" = "blue"
+    "position" = {
+        "x" = "123"
+        "y" = { "z" = "456" }
+    }
+    "size" = { "w" = "1" }
+})";
+
+std::string print(rexpr::ast::rexpr const& r)
+{
+    std::ostringstream out;
+    rexpr::ast::rexpr_printer{out}(r);
+    return out.str();
+}
+
+// The document parsed from scratch
+std::string reference(std::string const& text)
+{
+    std::ostringstream err;
+    rexpr::incremental_parser fresh(text, err);
+    return print(fresh.ast());
+}
+
+void replace(rexpr::incremental_parser& p, std::string const& what, std::string const& with,
+             reparse expected)
+{
+    auto const offset = p.text().find(what);
+    REQUIRE(offset != std::string::npos);
+    CHECK(p.edit(offset, what.size(), with) == expected);
+    CHECK(p.ok());
+    CHECK(print(p.ast()) == reference(p.text()));
+}
+} // namespace
+
+TEST_CASE("edits re-parse the innermost enclosing rexpr", "[incremental]")
+{
+    std::ostringstream err;
+    rexpr::incremental_parser p(example, err);
+    REQUIRE(p.ok());
+
+    replace(p, "\"456\"", "\"789\"", reparse::partial);
+    CHECK(p.last_reparsed_bytes() == std::string("{ \"z\" = \"789\" }").size());
+
+    replace(p, "\"x\" = \"123\"", "\"x\" = \"1\" \"x2\" = { }", reparse::partial);
+    replace(p, "\"w\" = \"1\"", "\"w\" = \"2\" \"h\" = \"3\"", reparse::partial);
+    replace(p, "\"y\"", "\"yy\"", reparse::partial);
+
+    // Spans behind earlier edits have moved along
+    replace(p, "\"3\"", "\"4\"", reparse::partial);
+    replace(p, "\"z\"", "\"zz\"", reparse::partial);
+    CHECK(err.str().empty());
+}
+
+TEST_CASE("edits outside nested rexprs parse the whole document", "[incremental]")
+{
+    std::ostringstream err;
+    rexpr::incremental_parser p(example, err);
+
+    replace(p, "\"blue\"", "\"red\"", reparse::full);
+    CHECK(p.last_reparsed_bytes() == p.text().size());
+    replace(p, "\"position\" = {", "\"pos\" = {", reparse::full);
+    replace(p, "\"w\"", "\"w2\" = \"0\" \"w\"", reparse::partial);
+}
+
+TEST_CASE("edits that change the structure fall back to a full parse", "[incremental]")
+{
+    std::ostringstream err;
+    rexpr::incremental_parser p(example, err);
+
+    // Closes "y" and opens a sibling; the old span of "y" no longer parses
+    auto const offset = p.text().find("\"z\" = \"456\" }");
+    CHECK(p.edit(offset, 0, "} \"q\" = {") == reparse::full);
+    CHECK(p.ok());
+    CHECK(print(p.ast()) == reference(p.text()));
+    CHECK(err.str().empty());
+}
+
+TEST_CASE("broken edits keep the last good AST", "[incremental]")
+{
+    std::ostringstream err;
+    rexpr::incremental_parser p(example, err);
+    std::string const before = print(p.ast());
+
+    auto const offset = p.text().find("= \"456\"");
+    CHECK(p.edit(offset, 1, ":") == reparse::failed);
+    CHECK_FALSE(p.ok());
+    CHECK(print(p.ast()) == before);
+    CHECK(err.str().find("Expecting: '='") != std::string::npos);
+
+    CHECK(p.edit(offset, 1, "=") == reparse::full);
+    CHECK(p.ok());
+    CHECK(print(p.ast()) == before);
+}
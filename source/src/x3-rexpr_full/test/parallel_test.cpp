@@ -0,0 +1,103 @@
+#include "rexpr/parallel.hpp"
+#include "rexpr/printer.hpp"
+
+#include <catch.hpp>
+
+#include <sstream>
+#include <string>
+
+namespace
+{
+std::string const example = R"({
+    "color" = "blue"
+    "size" = "29 cm."
+    "position" = {
+        "x" = "123"
+        "y" = "456"
+    }
+    "shape" = { "kind" = "{circle}" }
+    "color" = "red"
+    "name" = "}{"
+})";
+
+std::string parse(std::string const& text, unsigned threads)
+{
+    std::ostringstream out;
+    if (auto const ast = rexpr::parse_parallel(text.data(), text.data() + text.size(), out,
+                                               threads, "input"))
+        rexpr::ast::rexpr_printer{out}(*ast);
+    return out.str();
+}
+} // namespace
+
+TEST_CASE("scan_entries finds the top-level entries", "[parallel]")
+{
+    auto const starts = rexpr::scan_entries(example.data(), example.data() + example.size());
+    REQUIRE(starts.size() == 7);
+    CHECK(std::string(starts[0], 7) == "\"color\"");
+    CHECK(std::string(starts[2], 10) == "\"position\"");
+    CHECK(std::string(starts[3], 7) == "\"shape\"");
+    CHECK(std::string(starts[5], 6) == "\"name\"");
+    CHECK(*starts[6] == '}');
+    CHECK(starts[6] == example.data() + example.size() - 1);
+}
+
+TEST_CASE("scan_entries steps over typed values and arrays", "[parallel]")
+{
+    std::string const typed = R"({ "a" = 1 "b" = ["x" { "c" = "]" } [true]]
+        "d" = -2.5 "e" = "s" "f" = false })";
+    auto const starts = rexpr::scan_entries(typed.data(), typed.data() + typed.size());
+    REQUIRE(starts.size() == 6);
+    CHECK(std::string(starts[1], 3) == "\"b\"");
+    CHECK(std::string(starts[2], 3) == "\"d\"");
+    CHECK(std::string(starts[4], 3) == "\"f\"");
+    CHECK(parse(typed, 3) == parse(typed, 1));
+
+    std::string const mismatched = "{ \"a\" = [1 } ]";
+    char const* const first = mismatched.data();
+    CHECK(rexpr::scan_entries(first, first + mismatched.size()).empty());
+}
+
+TEST_CASE("scan_entries rejects unbalanced input", "[parallel]")
+{
+    std::string const open = "{ \"a\" = { \"b\" = \"c\" }";
+    std::string const quote = "{ \"a\" = \"b }";
+    CHECK(rexpr::scan_entries(open.data(), open.data() + open.size()).empty());
+    CHECK(rexpr::scan_entries(quote.data(), quote.data() + quote.size()).empty());
+}
+
+TEST_CASE("parse_parallel matches the serial parse", "[parallel]")
+{
+    std::string big = "{\n";
+    for (int i = 0; i < 500; ++i)
+    {
+        auto const n = std::to_string(i % 400);
+        big += "\"k" + n + "\" = { \"v\" = \"" + std::to_string(i) + "\" }\n\"s" + n + "\" = \"" +
+               n + "\"\n";
+    }
+    big += "}\n";
+
+    for (unsigned threads : {1u, 2u, 3u, 8u})
+    {
+        CHECK(parse(example, threads) == parse(example, 1));
+        CHECK(parse(big, threads) == parse(big, 1));
+    }
+    CHECK(parse(big, 4).find("\"k0\" = {\n        \"v\" = \"0\"") != std::string::npos);
+}
+
+TEST_CASE("parse_parallel reports errors like the serial parse", "[parallel]")
+{
+    std::string bad = "{\n";
+    for (int i = 0; i < 100; ++i)
+        bad += "\"k" + std::to_string(i) + "\" = \"v\"\n";
+    bad += "\"broken\" \"v\"\n";
+    for (int i = 100; i < 200; ++i)
+        bad += "\"k" + std::to_string(i) + "\" = \"v\"\n";
+    bad += "}";
+
+    auto const message = parse(bad, 4);
+    CHECK(message == parse(bad, 1));
+    CHECK(message.find("line 102") != std::string::npos);
+    CHECK(parse(bad + " trailing", 4).find("line 102") != std::string::npos);
+    CHECK(parse("{} trailing", 4).find("Expecting end of input") != std::string::npos);
+}
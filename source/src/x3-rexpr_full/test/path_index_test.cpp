@@ -0,0 +1,89 @@
+#include "rexpr/bulk.hpp"
+#include "rexpr/path_index.hpp"
+
+#include <catch.hpp>
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+rexpr::ast::rexpr parse(std::string const& text)
+{
+    rexpr::ast::rexpr result;
+    std::ostringstream err;
+    rexpr::parse_all(text.data(), text.data() + text.size(),
+                     [&](rexpr::ast::rexpr&& r) { result = std::move(r); }, err);
+    return result;
+}
+
+std::string text_at(rexpr::path_index const& index, rexpr::path_index::path const& p)
+{
+    auto const value = index.find(p);
+    return value ? boost::get<std::string>(*value) : "<none>";
+}
+} // namespace
+
+TEST_CASE("path_index finds values at any depth", "[path_index]")
+{
+    auto const doc = parse(R"({
+        "color" = "blue"
+        "position" = {
+            "x" = "123"
+            "y" = { "z" = "456" }
+        }
+    })");
+    rexpr::path_index const index(doc);
+
+    CHECK(index.size() == 5);
+    CHECK(text_at(index, {"color"}) == "blue");
+    CHECK(text_at(index, {"position", "x"}) == "123");
+    CHECK(text_at(index, {"position", "y", "z"}) == "456");
+
+    auto const position = index.find({"position"});
+    REQUIRE(position);
+    CHECK(position == &doc.entries.at("position"));
+}
+
+TEST_CASE("path_index tells paths apart by their keys", "[path_index]")
+{
+    auto const doc = parse(R"({
+        "a" = { "b" = "nested" }
+        "a b" = "spaced"
+        "ab" = "joined"
+    })");
+    rexpr::path_index const index(doc);
+
+    CHECK(text_at(index, {"a", "b"}) == "nested");
+    CHECK(text_at(index, {"a b"}) == "spaced");
+    CHECK(text_at(index, {"ab"}) == "joined");
+    CHECK(index.find({"b"}) == nullptr);
+    CHECK(index.find({"a", "b", "c"}) == nullptr);
+    CHECK(index.find({}) == nullptr);
+
+    // {"a\"b"} would be encoded like {"a", "b"}
+    CHECK_THROWS_AS(rexpr::path_index::path({"a\"b"}), std::invalid_argument);
+    CHECK_THROWS_AS(index.find({"a\"", "b"}), std::invalid_argument);
+    rexpr::ast::rexpr quoted;
+    quoted.entries.emplace("a\"b", std::string("quoted"));
+    CHECK_THROWS_AS(rexpr::path_index(quoted), std::invalid_argument);
+}
+
+TEST_CASE("path_index handles precompiled paths and large documents", "[path_index]")
+{
+    std::string text = "{";
+    for (int i = 0; i < 1000; ++i)
+        text += " \"k" + std::to_string(i) + "\" = { \"v\" = \"" + std::to_string(i) + "\" }";
+    text += " }";
+    auto const doc = parse(text);
+    rexpr::path_index const index(doc);
+
+    CHECK(index.size() == 2000);
+    std::vector<rexpr::path_index::path> paths;
+    for (int i = 0; i < 1000; ++i)
+        paths.emplace_back(std::vector<std::string>{"k" + std::to_string(i), "v"});
+    for (int i = 0; i < 1000; ++i)
+        CHECK(text_at(index, paths[static_cast<std::size_t>(i)]) == std::to_string(i));
+}
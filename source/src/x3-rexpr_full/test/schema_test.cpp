@@ -0,0 +1,142 @@
+#include "rexpr/schema.hpp"
+
+#include <catch.hpp>
+
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace schema_test
+{
+struct position
+{
+    int x = 0;
+    double y = 0;
+};
+
+struct shape
+{
+    std::string color;
+    std::string_view size;
+    bool visible = false;
+    position pos;
+};
+
+struct series
+{
+    std::vector<int> ids;
+    std::vector<position> points;
+    std::vector<bool> flags;
+    bool closed = false;
+};
+} // namespace schema_test
+
+BOOST_FUSION_ADAPT_STRUCT(schema_test::position, x, y)
+BOOST_FUSION_ADAPT_STRUCT(schema_test::shape, color, size, visible, pos)
+BOOST_FUSION_ADAPT_STRUCT(schema_test::series, ids, points, flags, closed)
+
+namespace
+{
+std::string const example = R"({
+    "color" = "blue"
+    "ignored" = { "a" = "{" "b" = { "c" = "}" } }
+    "size" = "29 cm."
+    "pos" = {
+        "x" = "-123"
+        "z" = "not in the schema"
+        "y" = "4.5"
+    }
+    "visible" = "true"
+    "color" = "red"
+})";
+
+bool extract(std::string const& text, schema_test::shape& out, std::string& errors)
+{
+    std::ostringstream err;
+    bool const ok =
+        rexpr::schema::extract(text.data(), text.data() + text.size(), out, err);
+    errors = err.str();
+    return ok;
+}
+} // namespace
+
+TEST_CASE("schema extraction fills the named members", "[schema]")
+{
+    schema_test::shape s;
+    std::string errors;
+    REQUIRE(extract(example, s, errors));
+
+    CHECK(s.color == "blue");
+    CHECK(s.size == "29 cm.");
+    CHECK(s.size.data() == example.data() + example.find("29 cm."));
+    CHECK(s.visible);
+    CHECK(s.pos.x == -123);
+    CHECK(s.pos.y == Approx(4.5));
+    CHECK(errors.empty());
+}
+
+TEST_CASE("schema extraction reads native values and arrays", "[schema]")
+{
+    std::string const text = R"({
+        "ids" = [1 2 "3"]
+        "skipped" = [[true] { "a" = ["]"] } 1.5]
+        "points" = [{ "x" = 4 "y" = -0.5 } {}]
+        "count" = 2
+        "flags" = [true false "true"]
+        "closed" = true
+    })";
+    schema_test::series s;
+    std::ostringstream err;
+    REQUIRE(rexpr::schema::extract(text.data(), text.data() + text.size(), s, err));
+    CHECK(s.ids == std::vector<int>{1, 2, 3});
+    REQUIRE(s.points.size() == 2);
+    CHECK(s.points[0].x == 4);
+    CHECK(s.points[0].y == Approx(-0.5));
+    CHECK(s.points[1].x == 0);
+    CHECK(s.flags == std::vector<bool>{true, false, true});
+    CHECK(s.closed);
+
+    std::string const bad = "{ \"ids\" = [1 2.5] }";
+    CHECK_FALSE(rexpr::schema::extract(bad.data(), bad.data() + bad.size(), s, err));
+    CHECK(err.str().find("Expecting: number") != std::string::npos);
+}
+
+TEST_CASE("schema extraction leaves missing members alone", "[schema]")
+{
+    schema_test::shape s;
+    s.pos.x = 7;
+    std::string errors;
+    REQUIRE(extract("{ \"color\" = \"green\" }", s, errors));
+    CHECK(s.color == "green");
+    CHECK(s.pos.x == 7);
+    CHECK_FALSE(s.visible);
+}
+
+TEST_CASE("schema extraction reports errors like the rexpr parser", "[schema]")
+{
+    schema_test::shape s;
+    std::string errors;
+
+    CHECK_FALSE(extract("{\n    \"color\" : \"blue\"\n}", s, errors));
+    CHECK(errors.find("line 2") != std::string::npos);
+    CHECK(errors.find("Expecting: '='") != std::string::npos);
+
+    CHECK_FALSE(extract("{ \"pos\" = { \"x\" = \"12a\" } }", s, errors));
+    CHECK(errors.find("Expecting: number") != std::string::npos);
+
+    CHECK_FALSE(extract("{ \"visible\" = \"yes\" }", s, errors));
+    CHECK(errors.find("Expecting: boolean") != std::string::npos);
+
+    CHECK_FALSE(extract("{ \"pos\" = \"flat\" }", s, errors));
+    CHECK(errors.find("Expecting: Value") != std::string::npos);
+
+    CHECK_FALSE(extract("{ \"other\" = { \"a\" = \"b\" }", s, errors));
+    CHECK(errors.find("Expecting: '}'") != std::string::npos);
+    CHECK_FALSE(extract("{ \"other\" = [{ \"a\" = [\"b\"] }", s, errors));
+    CHECK(errors.find("Expecting: ']'") != std::string::npos);
+    CHECK_FALSE(extract("{ \"other\" = [1 2} }", s, errors));
+    CHECK(errors.find("Expecting: ']'") != std::string::npos);
+    CHECK_FALSE(extract("{} {}", s, errors));
+    CHECK(errors.find("Expecting end of input") != std::string::npos);
+}
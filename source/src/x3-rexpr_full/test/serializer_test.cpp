@@ -0,0 +1,113 @@
+#include "rexpr/bulk.hpp"
+#include "rexpr/printer.hpp"
+#include "rexpr/serializer.hpp"
+
+#include <catch.hpp>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+namespace
+{
+std::string const example = R"({
+    "color" = "blue"
+    "empty" = {}
+    "position" = {
+        "x" = "123"
+        "y" = { "z" = "456 m" }
+    }
+})";
+
+std::string const typed = R"({
+    "count" = -42
+    "flags" = [true false]
+    "matrix" = [[1 2] [] [3.5 "x"]]
+    "points" = [{ "x" = 1 } { "x" = 2 "x" = 3 }]
+    "scale" = 1e3
+})";
+
+std::vector<rexpr::ast::rexpr> parse(std::string const& text)
+{
+    std::vector<rexpr::ast::rexpr> result;
+    std::ostringstream err;
+    rexpr::parse_all(text.data(), text.data() + text.size(),
+                     [&](rexpr::ast::rexpr&& r) { result.push_back(std::move(r)); }, err);
+    return result;
+}
+
+std::string print(rexpr::ast::rexpr const& r)
+{
+    std::ostringstream out;
+    rexpr::ast::rexpr_printer{out}(r);
+    return out.str();
+}
+} // namespace
+
+TEST_CASE("pretty serializer output matches the printer", "[serializer]")
+{
+    auto const r = parse(example).at(0);
+    CHECK(rexpr::to_string(r) == print(r));
+    CHECK(rexpr::to_string(rexpr::ast::rexpr{}) == print(rexpr::ast::rexpr{}));
+}
+
+TEST_CASE("compact serializer output leaves out whitespace", "[serializer]")
+{
+    auto const r = parse(example).at(0);
+    std::string const compact = rexpr::to_string(r, rexpr::layout::compact);
+    CHECK(compact ==
+          "{\"color\"=\"blue\"\"empty\"={}\"position\"={\"x\"=\"123\"\"y\"={\"z\"=\"456 m\"}}}\n");
+
+    auto const back = parse(compact);
+    REQUIRE(back.size() == 1);
+    CHECK(print(back[0]) == print(r));
+}
+
+TEST_CASE("serializer writes typed values and arrays", "[serializer]")
+{
+    auto const r = parse(typed).at(0);
+    CHECK(rexpr::to_string(r) == print(r));
+
+    std::string const compact = rexpr::to_string(r, rexpr::layout::compact);
+    CHECK(compact == "{\"count\"=-42\"flags\"=[true false]"
+                     "\"matrix\"=[[1 2] [] [3.5 \"x\"]]"
+                     "\"points\"=[{\"x\"=1} {\"x\"=2}]\"scale\"=1000.0}\n");
+    auto const back = parse(compact);
+    REQUIRE(back.size() == 1);
+    CHECK(print(back[0]) == print(r));
+}
+
+TEST_CASE("serializer collects several rexprs", "[serializer]")
+{
+    auto const r = parse(example).at(0);
+    rexpr::serializer s(rexpr::layout::compact);
+    s.write(r);
+    s.write(r);
+    CHECK(parse(std::string(s.buffer())).size() == 2);
+    s.clear();
+    CHECK(s.buffer().empty());
+}
+
+TEST_CASE("serializer writes to a file descriptor", "[serializer]")
+{
+    auto const r = parse(example).at(0);
+    int fds[2];
+    REQUIRE(::pipe(fds) == 0);
+    {
+        rexpr::serializer s(fds[1], rexpr::layout::pretty, 16);
+        s.write(r);
+        s.write(r);
+        CHECK(s.buffer().size() < 16);
+    }
+    ::close(fds[1]);
+
+    std::string out;
+    char chunk[256];
+    for (ssize_t n; (n = ::read(fds[0], chunk, sizeof chunk)) > 0;)
+        out.append(chunk, static_cast<std::size_t>(n));
+    ::close(fds[0]);
+
+    CHECK(out == print(r) + print(r));
+}
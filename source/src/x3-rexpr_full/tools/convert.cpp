@@ -0,0 +1,70 @@
+// Converts rexpr files between the text and the binary format.
+//
+//   rexpr.convert --to-binary input.rexpr output.rexb
+//   rexpr.convert --to-text input.rexb output.rexpr
+#include "rexpr/binary.hpp"
+#include "rexpr/bulk.hpp"
+#include "rexpr/mapped_file.hpp"
+#include "rexpr/printer.hpp"
+
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace
+{
+int to_binary(std::string const& input, std::string const& output)
+{
+    rexpr::mapped_file const text(input);
+    rexpr::ast::rexpr ast;
+    auto const result = rexpr::parse_all(
+        text.begin(), text.end(), [&](rexpr::ast::rexpr&& r) { ast = std::move(r); }, std::cerr,
+        input);
+    if (!result.ok)
+        return 1;
+    if (result.count != 1)
+    {
+        std::cerr << input << ": expected exactly one rexpr, found " << result.count << '\n';
+        return 1;
+    }
+
+    std::string const bytes = rexpr::binary::compile(ast);
+    std::ofstream out(output, std::ios::binary);
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    return out ? 0 : 1;
+}
+
+int to_text(std::string const& input, std::string const& output)
+{
+    rexpr::binary::file const binary(input);
+    std::ofstream out(output);
+    rexpr::ast::rexpr_printer{out}(rexpr::binary::to_ast(binary.root()));
+    return out ? 0 : 1;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc != 4)
+    {
+        std::cerr << "usage: " << argv[0] << " --to-binary|--to-text input output\n";
+        return 2;
+    }
+
+    std::string const mode = argv[1];
+    try
+    {
+        if (mode == "--to-binary")
+            return to_binary(argv[2], argv[3]);
+        if (mode == "--to-text")
+            return to_text(argv[2], argv[3]);
+    }
+    catch (std::exception const& e)
+    {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+    std::cerr << "unknown mode " << mode << '\n';
+    return 2;
+}